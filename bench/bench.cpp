@@ -0,0 +1,1177 @@
+// strangerBench: microbenchmarks for the engine hot paths.
+//
+// Usage: strangerBench [options]
+//   --isa NAME|all     Kernel level to run (default: best for this CPU; all = every supported level)
+//   --filter TEXT      Only run benchmarks whose name contains TEXT
+//   --quick            Fewer and shorter samples (smoke runs, CI)
+//   --csv PATH         Write the results as CSV (the format --compare reads)
+//   --compare PATH     Compare against a CSV baseline; exits with 1 if anything regressed
+//   --threshold PCT    Slowdown (median) that counts as a regression (default 10)
+//
+// Every result is the median (and minimum) of several samples, each one long
+// enough to be well above the clock resolution. Throughput is items per second
+// of the median, where items are whatever the benchmark moves (pixels, frames,
+// glyphs, bytes...).
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_resampler.h"
+#include "bmp.h"
+#include "cpu_features.h"
+#include "job_system.h"
+#include "kernels.h"
+#include "particles.h"
+#include "render.h"
+#include "rewind.h"
+#include "text.h"
+#include "world.h"
+
+// ##################################################################
+//                          Bench Types
+// ##################################################################
+
+// Results kept for the CSV / comparison
+#define BENCH_MAX_RESULTS 1024
+
+// Samples per result (the median is reported)
+#define BENCH_SAMPLES 11
+#define BENCH_QUICK_SAMPLES 5
+
+// Minimum duration of one sample in nanoseconds
+#define BENCH_SAMPLE_NS 5e6
+#define BENCH_QUICK_SAMPLE_NS 1e6
+
+// Largest back buffer used (4K)
+#define BENCH_MAX_WIDTH 3840
+#define BENCH_MAX_HEIGHT 2160
+
+// One timed call: runs the operation once on its context
+typedef void bench_function(void* context);
+
+struct BenchResult {
+    char name[96];
+    char isa[16];
+    double median_ns;           // Per call
+    double min_ns;
+    double items;               // Items moved per call
+    char unit[16];
+};
+
+struct BenchOptions {
+    const char* filter;
+    const char* csv_path;
+    const char* compare_path;
+    double threshold_percent;
+    bool quick;
+    bool all_isas;
+    CpuIsa isa;
+};
+
+static BenchOptions options;
+static BenchResult results[BENCH_MAX_RESULTS];
+static int result_count;
+
+// Set when a correctness check inside a benchmark fails
+static bool bench_failed;
+
+// ##################################################################
+//                          Timing
+// ##################################################################
+
+static double now_ns() {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Nanoseconds per call over a batch of calls
+static double time_batch(bench_function* function, void* context, int iterations) {
+    double begin = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        function(context);
+    }
+    return (now_ns() - begin) / (double)iterations;
+}
+
+static bool bench_selected(const char* name) {
+    return !options.filter || strstr(name, options.filter);
+}
+
+static BenchResult* record_result(const char* name, double* samples, int sample_count, double items, const char* unit) {
+    if (result_count == BENCH_MAX_RESULTS) return 0;
+
+    std::sort(samples, samples + sample_count);
+    BenchResult* result = &results[result_count++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    snprintf(result->isa, sizeof(result->isa), "%s", cpu_isa_name(global_kernels.isa));
+    snprintf(result->unit, sizeof(result->unit), "%s", unit);
+    result->median_ns = samples[sample_count / 2];
+    result->min_ns = samples[0];
+    result->items = items;
+
+    double per_second = result->median_ns > 0.0 ? items * 1e9 / result->median_ns : 0.0;
+    printf("%-46s %-7s %14.1f ns %14.1f ns %12.2f M%s/s\n",
+           result->name, result->isa, result->median_ns, result->min_ns, per_second / 1e6, result->unit);
+    fflush(stdout);
+    return result;
+}
+
+// Calibrates a batch size, then records the median of the samples
+static BenchResult* run_bench(const char* name, bench_function* function, void* context, double items, const char* unit) {
+    if (!bench_selected(name)) return 0;
+
+    int sample_count = options.quick ? BENCH_QUICK_SAMPLES : BENCH_SAMPLES;
+    double sample_ns = options.quick ? BENCH_QUICK_SAMPLE_NS : BENCH_SAMPLE_NS;
+
+    // Warm-up (caches, lazy allocations, layout caches), then grow the batch until it is long enough
+    function(context);
+    int iterations = 1;
+    while (iterations < (1 << 24) && time_batch(function, context, iterations) * iterations < sample_ns) {
+        iterations *= 2;
+    }
+
+    double samples[BENCH_SAMPLES];
+    for (int s = 0; s < sample_count; ++s) {
+        samples[s] = time_batch(function, context, iterations);
+    }
+    return record_result(name, samples, sample_count, items, unit);
+}
+
+// ##################################################################
+//                          Test Data
+// ##################################################################
+
+static uint32_t random_state = 0x12345678;
+
+// xorshift32
+static uint32_t random_u32() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+static float random_unit() {
+    return (float)(random_u32() >> 8) * (1.0f / 16777216.0f);
+}
+
+static uint32_t* back_buffer_memory;
+
+// A view of the shared back buffer memory at a given resolution
+static GameBuffer make_buffer(int width, int height) {
+    GameBuffer buffer;
+    buffer.memory = back_buffer_memory;
+    buffer.width = width;
+    buffer.height = height;
+    buffer.pitch = width * 4;
+    return buffer;
+}
+
+// Soft disc with every alpha from 0 to 255 (premultiplied), like particles and antialiased sprites
+static LoadedBitmap make_alpha_sprite(int size, uint32_t color) {
+    LoadedBitmap bitmap;
+    bitmap.width = size;
+    bitmap.height = size;
+    bitmap.pixels = (uint32_t*)malloc((size_t)size * size * sizeof(uint32_t));
+
+    float radius = 0.5f * (float)size;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float dx = ((float)x + 0.5f - radius) / radius;
+            float dy = ((float)y + 0.5f - radius) / radius;
+            float coverage = 1.0f - sqrtf(dx * dx + dy * dy);
+            if (coverage < 0.0f) coverage = 0.0f;
+
+            uint32_t alpha = (uint32_t)(255.0f * coverage + 0.5f);
+            uint32_t r = (uint32_t)((float)((color >> 16) & 0xFF) * coverage + 0.5f);
+            uint32_t g = (uint32_t)((float)((color >> 8) & 0xFF) * coverage + 0.5f);
+            uint32_t b = (uint32_t)((float)(color & 0xFF) * coverage + 0.5f);
+            bitmap.pixels[y * size + x] = (alpha << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+    return bitmap;
+}
+
+static void write_u16(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void write_u32(uint8_t* out, uint32_t value) {
+    write_u16(out, value);
+    write_u16(out + 2, value >> 16);
+}
+
+// Builds a bottom-up .bmp file in memory: 24-bit BI_RGB, 32-bit BI_ALPHABITFIELDS with the given masks,
+// or 32-bit BI_RGB with the 4th byte left at zero when masks is null
+static uint8_t* make_bmp_file(int width, int height, int bits_per_pixel, const uint32_t* masks, size_t* file_size) {
+    uint32_t mask_bytes = (bits_per_pixel == 32 && masks) ? 16 : 0;
+    uint32_t stride = ((uint32_t)width * (bits_per_pixel / 8) + 3) & ~3u;
+    uint32_t pixel_offset = 14 + 40 + mask_bytes;
+    *file_size = pixel_offset + (size_t)stride * height;
+
+    uint8_t* file = (uint8_t*)calloc(*file_size, 1);
+    file[0] = 'B';
+    file[1] = 'M';
+    write_u32(file + 2, (uint32_t)*file_size);
+    write_u32(file + 10, pixel_offset);
+
+    uint8_t* info = file + 14;
+    write_u32(info, 40);
+    write_u32(info + 4, (uint32_t)width);
+    write_u32(info + 8, (uint32_t)height);
+    write_u16(info + 12, 1);
+    write_u16(info + 14, (uint32_t)bits_per_pixel);
+    write_u32(info + 16, mask_bytes ? 6 : 0); // BI_ALPHABITFIELDS : BI_RGB
+    for (uint32_t i = 0; i < mask_bytes / 4; ++i) {
+        write_u32(info + 40 + 4 * i, masks[i]);
+    }
+
+    // Noise with varied alpha (the 32-bit paths premultiply)
+    uint8_t* pixels = file + pixel_offset;
+    for (int y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < (uint32_t)width * (bits_per_pixel / 8); ++x) {
+            pixels[y * stride + x] = (uint8_t)random_u32();
+            if (bits_per_pixel == 32 && !masks && x % 4 == 3) pixels[y * stride + x] = 0;
+        }
+    }
+    return file;
+}
+
+// ##################################################################
+//                          Render Benchmarks
+// ##################################################################
+
+struct DrawContext {
+    GameBuffer buffer;
+    LoadedBitmap* bitmap;
+    int x, y;
+    int width, height;
+};
+
+static void bench_draw_rect(void* context) {
+    DrawContext* draw = (DrawContext*)context;
+    draw_rect(&draw->buffer, draw->x, draw->y, draw->width, draw->height, 0xFF336699);
+}
+
+static void bench_draw_bitmap(void* context) {
+    DrawContext* draw = (DrawContext*)context;
+    draw_bitmap(&draw->buffer, draw->bitmap, draw->x, draw->y);
+}
+
+static void bench_draw_bitmap_alpha(void* context) {
+    DrawContext* draw = (DrawContext*)context;
+    draw_bitmap_alpha(&draw->buffer, draw->bitmap, (float)draw->x, (float)draw->y);
+}
+
+static void bench_draw_bitmap_additive(void* context) {
+    DrawContext* draw = (DrawContext*)context;
+    draw_bitmap_additive_region(&draw->buffer, draw->bitmap, 0, 0, draw->bitmap->width, draw->bitmap->height,
+                                draw->x, draw->y);
+}
+
+// Pixels a draw actually touches on screen
+static double visible_pixels(DrawContext* draw) {
+    int min_x = std::max(draw->x, 0);
+    int min_y = std::max(draw->y, 0);
+    int max_x = std::min(draw->x + draw->width, draw->buffer.width);
+    int max_y = std::min(draw->y + draw->height, draw->buffer.height);
+    if (max_x <= min_x || max_y <= min_y) return 0.0;
+    return (double)(max_x - min_x) * (double)(max_y - min_y);
+}
+
+struct Resolution {
+    const char* name;
+    int width, height;
+};
+
+static const Resolution resolutions[] = {
+    { "720p", 1280, 720 },
+    { "1080p", 1920, 1080 },
+    { "4k", 3840, 2160 },
+};
+
+static void run_render_benchmarks() {
+    static const int sprite_sizes[] = { 4, 16, 32, 64, 256 };
+    char name[96];
+
+    // Sprites on a 1080p buffer: unclipped (fully inside) and clipped (half off the top-left corner)
+    for (int s = 0; s < (int)(sizeof(sprite_sizes) / sizeof(sprite_sizes[0])); ++s) {
+        int size = sprite_sizes[s];
+        LoadedBitmap opaque = make_test_bitmap(size, size);
+        LoadedBitmap alpha = make_alpha_sprite(size, 0xFFA040);
+
+        for (int clipped = 0; clipped < 2; ++clipped) {
+            DrawContext draw;
+            draw.buffer = make_buffer(1920, 1080);
+            draw.x = clipped ? -size / 2 : 100;
+            draw.y = clipped ? -size / 2 : 100;
+            draw.width = size;
+            draw.height = size;
+            double pixels = visible_pixels(&draw);
+            const char* variant = clipped ? "clipped" : "unclipped";
+
+            snprintf(name, sizeof(name), "draw_rect/%dx%d/%s", size, size, variant);
+            run_bench(name, bench_draw_rect, &draw, pixels, "px");
+
+            draw.bitmap = &opaque;
+            snprintf(name, sizeof(name), "draw_bitmap/%dx%d/%s", size, size, variant);
+            run_bench(name, bench_draw_bitmap, &draw, pixels, "px");
+
+            draw.bitmap = &alpha;
+            snprintf(name, sizeof(name), "draw_bitmap_alpha/%dx%d/%s", size, size, variant);
+            run_bench(name, bench_draw_bitmap_alpha, &draw, pixels, "px");
+
+            snprintf(name, sizeof(name), "draw_bitmap_additive/%dx%d/%s", size, size, variant);
+            run_bench(name, bench_draw_bitmap_additive, &draw, pixels, "px");
+        }
+        free(opaque.pixels);
+        free(alpha.pixels);
+    }
+
+    // Full screen at each resolution (the background / clear cost)
+    for (int r = 0; r < (int)(sizeof(resolutions) / sizeof(resolutions[0])); ++r) {
+        const Resolution* resolution = &resolutions[r];
+        LoadedBitmap opaque = make_test_bitmap(resolution->width, resolution->height);
+        LoadedBitmap alpha = make_alpha_sprite(resolution->width, 0x80C0FF);
+        alpha.height = resolution->height; // Top rows of a square disc: the same mix of alphas
+
+        DrawContext draw;
+        draw.buffer = make_buffer(resolution->width, resolution->height);
+        draw.x = 0;
+        draw.y = 0;
+        draw.width = resolution->width;
+        draw.height = resolution->height;
+        double pixels = visible_pixels(&draw);
+
+        snprintf(name, sizeof(name), "draw_rect/fullscreen/%s", resolution->name);
+        run_bench(name, bench_draw_rect, &draw, pixels, "px");
+
+        draw.bitmap = &opaque;
+        snprintf(name, sizeof(name), "draw_bitmap/fullscreen/%s", resolution->name);
+        run_bench(name, bench_draw_bitmap, &draw, pixels, "px");
+
+        draw.bitmap = &alpha;
+        snprintf(name, sizeof(name), "draw_bitmap_alpha/fullscreen/%s", resolution->name);
+        run_bench(name, bench_draw_bitmap_alpha, &draw, pixels, "px");
+
+        free(opaque.pixels);
+        free(alpha.pixels);
+    }
+}
+
+// ##################################################################
+//                          Rasterizer Benchmarks
+// ##################################################################
+
+// Triangles (or lines) per benchmark call
+#define BENCH_TRIANGLE_COUNT 1024
+
+struct TriangleContext {
+    GameBuffer buffer;
+    float vertices[BENCH_TRIANGLE_COUNT][6];   // x0 y0 x1 y1 x2 y2 (lines: x0 y0 x1 y1)
+    float thickness;
+};
+
+static void bench_draw_triangle(void* context) {
+    TriangleContext* draw = (TriangleContext*)context;
+    for (int i = 0; i < BENCH_TRIANGLE_COUNT; ++i) {
+        const float* v = draw->vertices[i];
+        draw_triangle(&draw->buffer, v[0], v[1], v[2], v[3], v[4], v[5], 0xFF4080C0);
+    }
+}
+
+static void bench_draw_line(void* context) {
+    TriangleContext* draw = (TriangleContext*)context;
+    for (int i = 0; i < BENCH_TRIANGLE_COUNT; ++i) {
+        const float* v = draw->vertices[i];
+        draw_line(&draw->buffer, v[0], v[1], v[2], v[3], draw->thickness, 0xFFE0C040);
+    }
+}
+
+// Random triangles of about size x size pixels (any orientation, subpixel positions).
+// Clipped: the centers spread past the screen edges, so about half of every triangle is off screen
+static void make_bench_triangles(TriangleContext* draw, float size, bool clipped) {
+    float margin = clipped ? 0.0f : size;
+    float range_x = (float)draw->buffer.width - (clipped ? 0.0f : 2.0f * size);
+    float range_y = (float)draw->buffer.height - (clipped ? 0.0f : 2.0f * size);
+
+    for (int i = 0; i < BENCH_TRIANGLE_COUNT; ++i) {
+        float center_x = margin + random_unit() * range_x;
+        float center_y = margin + random_unit() * range_y;
+        if (clipped) {
+            // Center on one of the four screen edges
+            if (random_u32() & 1) center_x = (random_u32() & 1) ? 0.0f : (float)draw->buffer.width;
+            else center_y = (random_u32() & 1) ? 0.0f : (float)draw->buffer.height;
+        }
+        float angle = random_unit() * 6.2831853f;
+        for (int k = 0; k < 3; ++k) {
+            float corner = angle + (float)k * 2.0943951f + 0.5f * (random_unit() - 0.5f);
+            draw->vertices[i][2 * k] = center_x + 0.6f * size * cosf(corner);
+            draw->vertices[i][2 * k + 1] = center_y + 0.6f * size * sinf(corner);
+        }
+    }
+}
+
+// The rasterizer's own unit: triangles (or lines) per millisecond
+static void print_per_millisecond(BenchResult* result) {
+    if (!result || result->median_ns <= 0.0) return;
+    printf("  %s: %.0f %s/ms\n", result->name, result->items * 1e6 / result->median_ns, result->unit);
+}
+
+static void run_raster_benchmarks() {
+    static const int triangle_sizes[] = { 8, 32, 256 };
+    static TriangleContext draw;
+    draw.buffer = make_buffer(1920, 1080);
+    char name[96];
+
+    for (int s = 0; s < (int)(sizeof(triangle_sizes) / sizeof(triangle_sizes[0])); ++s) {
+        int size = triangle_sizes[s];
+        for (int clipped = 0; clipped < 2; ++clipped) {
+            snprintf(name, sizeof(name), "draw_triangle/%dpx/%s", size, clipped ? "clipped" : "unclipped");
+            if (!bench_selected(name)) continue;
+
+            make_bench_triangles(&draw, (float)size, clipped != 0);
+            print_per_millisecond(run_bench(name, bench_draw_triangle, &draw, BENCH_TRIANGLE_COUNT, "tris"));
+        }
+    }
+
+    // Lines: random directions, 256 px long, hairline and thick
+    static const float thicknesses[] = { 1.0f, 4.0f };
+    for (int t = 0; t < 2; ++t) {
+        snprintf(name, sizeof(name), "draw_line/256px/%gpx", thicknesses[t]);
+        if (!bench_selected(name)) continue;
+
+        for (int i = 0; i < BENCH_TRIANGLE_COUNT; ++i) {
+            float angle = random_unit() * 6.2831853f;
+            float x = 128.0f + random_unit() * (float)(draw.buffer.width - 256);
+            float y = 128.0f + random_unit() * (float)(draw.buffer.height - 256);
+            draw.vertices[i][0] = x - 128.0f * cosf(angle);
+            draw.vertices[i][1] = y - 128.0f * sinf(angle);
+            draw.vertices[i][2] = x + 128.0f * cosf(angle);
+            draw.vertices[i][3] = y + 128.0f * sinf(angle);
+        }
+        draw.thickness = thicknesses[t];
+        print_per_millisecond(run_bench(name, bench_draw_line, &draw, BENCH_TRIANGLE_COUNT, "lines"));
+    }
+}
+
+// ##################################################################
+//                          Asset Benchmarks
+// ##################################################################
+
+struct TestBitmapContext {
+    int size;
+};
+
+static void bench_make_test_bitmap(void* context) {
+    TestBitmapContext* test = (TestBitmapContext*)context;
+    LoadedBitmap bitmap = make_test_bitmap(test->size, test->size);
+    free(bitmap.pixels);
+}
+
+struct BmpContext {
+    uint8_t* file;
+    size_t size;
+};
+
+static void bench_bmp_decode(void* context) {
+    BmpContext* bmp = (BmpContext*)context;
+    LoadedBitmap bitmap;
+    if (bmp_decode(bmp->file, bmp->size, &bitmap) != BMP_OK) bench_failed = true;
+    bmp_free(&bitmap);
+}
+
+static void run_asset_benchmarks() {
+    char name[96];
+
+    static const int bitmap_sizes[] = { 32, 256, 1024 };
+    for (int s = 0; s < (int)(sizeof(bitmap_sizes) / sizeof(bitmap_sizes[0])); ++s) {
+        TestBitmapContext test = { bitmap_sizes[s] };
+        snprintf(name, sizeof(name), "make_test_bitmap/%dx%d", test.size, test.size);
+        run_bench(name, bench_make_test_bitmap, &test, (double)test.size * test.size, "px");
+    }
+
+    // 1024x1024 files: the fast paths (24-bit, 32-bit BGRA, 32-bit BGRX) and the generic mask path
+    static const uint32_t bgra_masks[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 };
+    static const uint32_t rgba_masks[4] = { 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000 };
+    struct { const char* name; int bits; const uint32_t* masks; } formats[] = {
+        { "bmp_decode/24bit/1024x1024", 24, 0 },
+        { "bmp_decode/32bit_bgra/1024x1024", 32, bgra_masks },
+        { "bmp_decode/32bit_bgrx/1024x1024", 32, 0 },
+        { "bmp_decode/32bit_rgba_masks/1024x1024", 32, rgba_masks },
+    };
+    for (int f = 0; f < (int)(sizeof(formats) / sizeof(formats[0])); ++f) {
+        if (!bench_selected(formats[f].name)) continue;
+
+        BmpContext bmp;
+        bmp.file = make_bmp_file(1024, 1024, formats[f].bits, formats[f].masks, &bmp.size);
+        run_bench(formats[f].name, bench_bmp_decode, &bmp, (double)bmp.size, "B");
+        free(bmp.file);
+    }
+}
+
+// ##################################################################
+//                          Audio Benchmarks
+// ##################################################################
+
+// One second of output at 48 kHz per call
+#define BENCH_AUDIO_RATE 48000
+
+struct AudioContext {
+    SoundMixer mixer;
+    int16_t* samples;
+    float tone_phase;
+};
+
+static void bench_write_samples(void* context) {
+    AudioContext* audio = (AudioContext*)context;
+    mixer_write_samples(&audio->mixer, audio->samples, BENCH_AUDIO_RATE, &audio->tone_phase,
+                        2.0f * 3.14159265f * 256.0f / (float)BENCH_AUDIO_RATE, 3000.0f);
+}
+
+static void run_audio_benchmarks() {
+    static const int voice_counts[] = { 0, 1, 8, MIXER_MAX_VOICES };
+    static bool tables_ready;
+    if (!tables_ready) {
+        resampler_init_tables();
+        tables_ready = true;
+    }
+
+    // The game's jump sound (22.05 kHz, resampled), looping with different pitches so every filter bank is used
+    LoadedSound sound = make_test_sound(22050, 2.0f);
+    static AudioContext audio;
+    audio.samples = (int16_t*)malloc(BENCH_AUDIO_RATE * 2 * sizeof(int16_t));
+
+    char name[96];
+    BenchResult* silent = 0;
+    BenchResult* busiest = 0;
+    for (int c = 0; c < (int)(sizeof(voice_counts) / sizeof(voice_counts[0])); ++c) {
+        memset(&audio.mixer, 0, sizeof(audio.mixer));
+        audio.mixer.output_samples_per_second = BENCH_AUDIO_RATE;
+        audio.tone_phase = 0.0f;
+        for (int v = 0; v < voice_counts[c]; ++v) {
+            mixer_play_sound(&audio.mixer, &sound, 0.5f, 0.6f + 1.4f * (float)v / MIXER_MAX_VOICES, true);
+        }
+
+        snprintf(name, sizeof(name), "mixer_write_samples/%d_voices", voice_counts[c]);
+        BenchResult* result = run_bench(name, bench_write_samples, &audio, BENCH_AUDIO_RATE, "frames");
+        if (voice_counts[c] == 0) silent = result;
+        if (voice_counts[c] == MIXER_MAX_VOICES) busiest = result;
+    }
+
+    // Marginal cost of one voice: the slope between no voices and every voice busy
+    if (silent && busiest) {
+        double per_voice[1] = { (busiest->median_ns - silent->median_ns) / MIXER_MAX_VOICES };
+        record_result("mixer_write_samples/per_voice", per_voice, 1, BENCH_AUDIO_RATE, "frames");
+    }
+
+    free(audio.samples);
+    free(sound.samples[0]);
+}
+
+// ##################################################################
+//                          Text Benchmarks
+// ##################################################################
+
+struct TextContext {
+    GameBuffer buffer;
+    TextRenderer* renderer;
+    const char* text;
+    uint32_t frame;             // Drives the numbers that change every frame
+    bool overdraw_lines;        // F1 on: the overdraw totals are added
+    int glyph_count;            // Glyphs of the last call
+};
+
+static void bench_draw_text(void* context) {
+    TextContext* text = (TextContext*)context;
+    text->glyph_count = draw_text(&text->buffer, text->renderer, text->text, 8, 8);
+}
+
+static void overlay_bench_line(TextContext* text, int* y, const char* format, ...) {
+    char line[TEXT_MAX_LAYOUT_CHARS + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    text->glyph_count += draw_text(&text->buffer, text->renderer, line, 8, *y);
+    *y += text->renderer->font.line_height;
+}
+
+// The stats overlay as the game draws it: one formatted line per draw_text, with the
+// frame-dependent numbers changing on every call (those lines miss the layout cache)
+static void bench_draw_overlay(void* context) {
+    TextContext* text = (TextContext*)context;
+    uint32_t frame = text->frame++;
+    float frame_ms = 16.0f + (float)(frame % 97) * 0.01f;
+    int y = 8;
+    text->glyph_count = 0;
+
+    overlay_bench_line(text, &y, "FRAME %.2f MS (%.0f FPS)", frame_ms, 1000.0f / frame_ms);
+    overlay_bench_line(text, &y, "KERNELS %s  THREADS %d", "AVX2", 8);
+    overlay_bench_line(text, &y, "INPUT LATENCY AVG %.1f MS  MAX %.1f MS", 12.3f, 20.1f);
+    overlay_bench_line(text, &y, "PARTICLES %d", 400 + (int)(frame % 50));
+    overlay_bench_line(text, &y, "LEVEL %d OBJECTS  %d CANDIDATES  %d DRAWN", 193, 15 + (int)(frame / 30 % 4), 11);
+    overlay_bench_line(text, &y, "REWIND %.1f S  %.0f KB/S", 10.0f + (float)frame / 60.0f, 468.0f + (float)(frame % 7));
+    overlay_bench_line(text, &y, "SNAPSHOT %u/%u B %.3f MS  RESTORE %.1f US",
+                       7800 + frame % 300, 9604 + (frame % 50) * 24, 0.030f + (float)(frame % 9) * 0.001f, 10.0f);
+    overlay_bench_line(text, &y, "TEXT %d GLYPHS %.3f MS (%.0f GLYPHS/MS)  %u LAYOUT MISSES",
+                       250 + (int)(frame % 5), 0.017f + (float)(frame % 11) * 0.001f, 14000.0f + (float)(frame % 13), 6u);
+
+    if (text->overdraw_lines) {
+        overlay_bench_line(text, &y, "OVERDRAW %.2f WRITES/PIXEL", 1.9f + (float)(frame % 17) * 0.01f);
+        for (int i = 0; i < DRAW_FUNCTION_COUNT; ++i) {
+            overlay_bench_line(text, &y, "%s %u CALLS  %llu FILLED  %llu BLENDED  %llu SKIPPED  %llu CLIPPED",
+                               draw_function_name((DrawFunction)i), 20 + frame % 3,
+                               (unsigned long long)(921600 + frame % 1000), (unsigned long long)(80000 + frame % 900),
+                               (unsigned long long)(20000 + frame % 800), (unsigned long long)(3000 + frame % 700));
+        }
+    }
+}
+
+static void run_text_benchmarks() {
+    if (!bench_selected("draw_text")) return;
+
+    static TextRenderer renderer;
+    if (!text_init(&renderer, 2, 0xFFFFFF)) return;
+
+    TextContext text = {};
+    text.buffer = make_buffer(1920, 1080);
+    text.renderer = &renderer;
+
+    // Fixed text: every line is a cache hit after the first call
+    text.text = "FRAME 16.67 MS (60 FPS)\n"
+                "KERNELS AVX2  THREADS 8\n"
+                "INPUT LATENCY AVG 12.3 MS  MAX 20.1 MS\n"
+                "PARTICLES 12345\n"
+                "LEVEL 193 OBJECTS  15 CANDIDATES  11 DRAWN\n"
+                "TEXT 200 GLYPHS 0.017 MS";
+    bench_draw_text(&text);
+    run_bench("draw_text/static", bench_draw_text, &text, text.glyph_count, "glyphs");
+
+    // The real overlay, without and with the F1 overdraw lines
+    for (int overdraw = 0; overdraw < 2; ++overdraw) {
+        const char* name = overdraw ? "draw_text/overlay_overdraw" : "draw_text/overlay";
+        text.overdraw_lines = overdraw != 0;
+        bench_draw_overlay(&text);
+
+        uint32_t hits_begin = renderer.cache_hits;
+        uint32_t misses_begin = renderer.cache_misses;
+        BenchResult* result = run_bench(name, bench_draw_overlay, &text, text.glyph_count, "glyphs");
+        if (result) {
+            uint32_t hits = renderer.cache_hits - hits_begin;
+            uint32_t misses = renderer.cache_misses - misses_begin;
+            printf("  %s: %d glyphs, layout cache %.0f%% hits\n", name, text.glyph_count,
+                   100.0 * hits / (double)(hits + misses > 0 ? hits + misses : 1));
+        }
+    }
+    if (renderer.truncated_layouts > 0) {
+        printf("  draw_text: %u layouts truncated\n", renderer.truncated_layouts);
+        bench_failed = true;
+    }
+    free(renderer.font.atlas.pixels);
+}
+
+// ##################################################################
+//                          Particle Benchmarks
+// ##################################################################
+
+struct ParticleContext {
+    GameBuffer buffer;
+    ParticlePool* pool;
+};
+
+static void bench_particles_update(void* context) {
+    ParticleContext* particles = (ParticleContext*)context;
+    particles_update(particles->pool, 1.0f / 60.0f, 0.0f);
+}
+
+static void bench_particles_render(void* context) {
+    ParticleContext* particles = (ParticleContext*)context;
+    particles_render(&particles->buffer, particles->pool, 0.0f, 0.0f);
+}
+
+// Fills a pool with count particles spread over a 1080p screen, living long enough to never die while timed
+static void fill_pool(ParticlePool* pool, int count) {
+    ParticleEmitter emitter = {};
+    emitter.x = 960.0f;
+    emitter.y = 540.0f;
+    emitter.angle = 0.0f;
+    emitter.spread = 3.14159265f;
+    emitter.speed_min = 0.0f;
+    emitter.speed_max = 500.0f;
+    emitter.life_min = 1.0e6f;
+    emitter.life_max = 2.0e6f;
+    emitter.random_state = 0xC0FFEE;
+
+    pool->count = 0;
+    particles_burst(pool, &emitter, count);
+    particles_update(pool, 1.0f, 0.0f); // One second of flight: a disc of 500 px radius
+}
+
+static void run_particle_benchmarks() {
+    if (!bench_selected("particles")) return;
+
+    ParticlePool alpha_pool;
+    ParticlePool additive_pool;
+    if (!particles_init(&alpha_pool, 6, 0xB0A890, PARTICLE_BLEND_ALPHA)) return;
+    if (!particles_init(&additive_pool, 4, 0xFFA040, PARTICLE_BLEND_ADDITIVE)) {
+        particles_free(&alpha_pool);
+        return;
+    }
+
+    ParticleContext particles;
+    particles.buffer = make_buffer(1920, 1080);
+    char name[96];
+
+    static const int counts[] = { 1000, 100000 };
+    for (int c = 0; c < 2; ++c) {
+        int count = counts[c];
+
+        particles.pool = &additive_pool;
+        fill_pool(&additive_pool, count);
+        snprintf(name, sizeof(name), "particles_update/%d", count);
+        run_bench(name, bench_particles_update, &particles, count, "particles");
+
+        fill_pool(&additive_pool, count);
+        snprintf(name, sizeof(name), "particles_render/additive_4px/%d", count);
+        run_bench(name, bench_particles_render, &particles, count, "particles");
+
+        particles.pool = &alpha_pool;
+        fill_pool(&alpha_pool, count);
+        snprintf(name, sizeof(name), "particles_render/alpha_6px/%d", count);
+        run_bench(name, bench_particles_render, &particles, count, "particles");
+    }
+
+    particles_free(&alpha_pool);
+    particles_free(&additive_pool);
+}
+
+// ##################################################################
+//                          World Benchmarks
+// ##################################################################
+
+// Level density of the game: 12 objects per 1280 px screen
+#define BENCH_OBJECTS_PER_SCREEN 12
+
+// Random query boxes (player sized) per query benchmark call
+#define BENCH_QUERY_COUNT 1024
+
+struct WorldContext {
+    GameBuffer buffer;
+    World world;
+    Camera camera;
+    CullStats stats;
+    AABB queries[BENCH_QUERY_COUNT];
+    int hits;
+};
+
+static void bench_world_render(void* context) {
+    WorldContext* level = (WorldContext*)context;
+    world_render(&level->buffer, &level->world, &level->camera, &level->stats);
+}
+
+static void bench_world_query(void* context) {
+    WorldContext* level = (WorldContext*)context;
+    int found[16];
+    for (int q = 0; q < BENCH_QUERY_COUNT; ++q) {
+        level->hits += world_query(&level->world, level->queries[q], found, 16);
+    }
+}
+
+// Same layout rules as the game's test level (random platforms over two screens of height)
+static bool make_bench_level(World* world, int screens) {
+    float width = 1280.0f * (float)screens;
+    int object_count = screens * BENCH_OBJECTS_PER_SCREEN;
+    if (!world_init(world, width, -720.0f, 1440.0f, object_count)) return false;
+
+    for (int i = 0; i < object_count; ++i) {
+        AABB box;
+        box.w = (float)(80 + (random_u32() & 0xFF));
+        box.h = (float)(16 + (random_u32() & 0x1F));
+        box.x = random_unit() * (width - box.w);
+        box.y = -700.0f + random_unit() * 1100.0f;
+        world_add_object(world, box, 0xFF607080);
+    }
+    return world_build_grid(world);
+}
+
+static void run_world_benchmarks() {
+    // Culling cost must stay flat when the level grows (same density, wider level)
+    static const int level_screens[] = { 16, 160, 1600 };
+    static WorldContext level;
+    char name[96];
+    BenchResult* render_results[3] = {};
+
+    for (int l = 0; l < 3; ++l) {
+        if (!make_bench_level(&level.world, level_screens[l])) continue;
+        level.buffer = make_buffer(1280, 720);
+        level.camera.width = 1280;
+        level.camera.height = 720;
+        camera_follow(&level.camera, &level.world, 0.5f * level.world.width, 0.0f);
+
+        for (int q = 0; q < BENCH_QUERY_COUNT; ++q) {
+            AABB box = { random_unit() * (level.world.width - 64.0f), -700.0f + random_unit() * 1300.0f, 64.0f, 64.0f };
+            level.queries[q] = box;
+        }
+
+        snprintf(name, sizeof(name), "world_render/%d_objects", level.world.object_count);
+        render_results[l] = run_bench(name, bench_world_render, &level, 1.0, "frames");
+
+        snprintf(name, sizeof(name), "world_query/%d_objects", level.world.object_count);
+        run_bench(name, bench_world_query, &level, BENCH_QUERY_COUNT, "queries");
+
+        world_free(&level.world);
+    }
+
+    if (render_results[0] && render_results[2]) {
+        double ratio = render_results[2]->median_ns / render_results[0]->median_ns;
+        printf("  culling: 100x the objects costs %.2fx the time (%s)\n", ratio, ratio < 2.0 ? "flat" : "NOT FLAT");
+    }
+}
+
+// ##################################################################
+//                          Rewind Benchmarks
+// ##################################################################
+
+// Recorded ticks replayed by the rewind benchmarks (10 seconds at 60 Hz; the stress images are
+// ~100x larger, and the game's 32 MB ring only holds ~20 of them anyway)
+#define BENCH_REWIND_TICKS 600
+#define BENCH_REWIND_STRESS_TICKS 40
+
+struct RewindContext {
+    RewindBuffer rewind;
+    ParticlePool pool;          // Restore target (like the game, every step back loads the image)
+    uint8_t* images;            // tick_count images of image_stride bytes
+    size_t image_sizes[BENCH_REWIND_TICKS];
+    size_t image_stride;
+    int tick_count;
+    int next_tick;
+};
+
+static void bench_rewind_push(void* context) {
+    RewindContext* history = (RewindContext*)context;
+    int tick = history->next_tick;
+    history->next_tick = (tick + 1) % history->tick_count;
+
+    size_t size = history->image_sizes[tick];
+    memcpy(rewind_begin_snapshot(&history->rewind), history->images + tick * history->image_stride, size);
+    rewind_push(&history->rewind, size, 1.0f / 60.0f);
+}
+
+// Records the sparks fountain at a given emission rate and times push and step back + load
+static void run_rewind_case(const char* case_name, float rate, int max_particles, int tick_count) {
+    char name[64];
+    snprintf(name, sizeof(name), "rewind/%s", case_name);
+    if (!bench_selected(name)) return;
+
+    // Game-like state: the sparks fountain simulated at 60 Hz (rate 400: ~470 alive, F3 stress: ~95k)
+    ParticlePool sparks;
+    if (!particles_init(&sparks, 4, 0xFFA040, PARTICLE_BLEND_ADDITIVE)) return;
+    ParticleEmitter emitter = { 650.0f, 400.0f, rate, 0.0f, -1.5708f, 0.6f, 200.0f, 600.0f, 0.8f, 1.6f, 12345 };
+
+    static RewindContext history;
+    history.tick_count = tick_count;
+    history.image_stride = sizeof(int) + (size_t)max_particles * PARTICLE_STATE_RECORD_SIZE;
+    history.images = (uint8_t*)malloc((size_t)tick_count * history.image_stride);
+    if (!history.images || !particles_init(&history.pool, 4, 0xFFA040, PARTICLE_BLEND_ADDITIVE)) {
+        free(history.images);
+        particles_free(&sparks);
+        return;
+    }
+    for (int warm_up = 0; warm_up < 120; ++warm_up) {
+        particles_emit(&sparks, &emitter, 1.0f / 60.0f);
+        particles_update(&sparks, 1.0f / 60.0f, 2000.0f);
+    }
+    for (int tick = 0; tick < tick_count; ++tick) {
+        particles_emit(&sparks, &emitter, 1.0f / 60.0f);
+        particles_update(&sparks, 1.0f / 60.0f, 2000.0f);
+        history.image_sizes[tick] = particles_save_state(&sparks, history.images + tick * history.image_stride);
+    }
+    particles_free(&sparks);
+
+    if (rewind_init(&history.rewind, 32u << 20, BENCH_REWIND_TICKS * 4, history.image_stride)) {
+        // Push: one tick recorded (steady state: the ring is always full enough to drop old ticks)
+        history.next_tick = 0;
+        snprintf(name, sizeof(name), "rewind/%s/push", case_name);
+        BenchResult* push = run_bench(name, bench_rewind_push, &history, 1.0, "ticks");
+        if (push) {
+            printf("  rewind: %u-byte images, %u-byte deltas -> %.0f KB of history per second at 60 ticks/s\n",
+                   history.rewind.last_image_size, history.rewind.last_delta_size,
+                   rewind_bytes_per_second(&history.rewind) / 1024.0);
+        }
+
+        snprintf(name, sizeof(name), "rewind/%s/step_back", case_name);
+        if (bench_selected(name)) {
+            // Step back + load (what the game's restore time measures): timed by hand, the history
+            // has to be refilled between samples
+            int sample_count = options.quick ? BENCH_QUICK_SAMPLES : BENCH_SAMPLES;
+            double samples[BENCH_SAMPLES];
+            for (int s = 0; s < sample_count; ++s) {
+                rewind_clear(&history.rewind);
+                for (int tick = 0; tick < tick_count; ++tick) bench_rewind_push(&history);
+
+                int steps = 0;
+                size_t image_size;
+                double begin = now_ns();
+                while (const uint8_t* image = rewind_step_back(&history.rewind, &image_size)) {
+                    particles_load_state(&history.pool, image);
+                    steps++;
+                }
+                samples[s] = (now_ns() - begin) / (double)(steps > 0 ? steps : 1);
+            }
+            record_result(name, samples, sample_count, 1.0, "ticks");
+        }
+        rewind_free(&history.rewind);
+    }
+    particles_free(&history.pool);
+    free(history.images);
+}
+
+static void run_rewind_benchmarks() {
+    if (!bench_selected("rewind")) return;
+
+    run_rewind_case("game", 400.0f, 2000, BENCH_REWIND_TICKS);
+    run_rewind_case("stress", 80000.0f, PARTICLE_MAX_COUNT, BENCH_REWIND_STRESS_TICKS);
+}
+
+// ##################################################################
+//                          Job System Benchmarks
+// ##################################################################
+
+// Indices per parallel_for call
+#define BENCH_JOB_COUNT (1 << 18)
+
+struct JobContext {
+    JobSystem* system;
+    std::atomic<uint32_t>* runs;    // Times each index was executed
+    uint32_t* output;
+    int batch_size;
+};
+
+// ~100 ns of ALU work per index, plus the run counter for the exactly-once check
+static void job_work(void* data, int begin, int end) {
+    JobContext* jobs = (JobContext*)data;
+    for (int i = begin; i < end; ++i) {
+        uint32_t value = (uint32_t)i * 2654435761u + 1;
+        for (int k = 0; k < 64; ++k) {
+            value ^= value << 13;
+            value ^= value >> 17;
+            value ^= value << 5;
+        }
+        jobs->output[i] = value;
+        jobs->runs[i].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void bench_parallel_for(void* context) {
+    JobContext* jobs = (JobContext*)context;
+    job_parallel_for(jobs->system, job_work, jobs, BENCH_JOB_COUNT, jobs->batch_size);
+}
+
+static void run_job_benchmarks() {
+    if (!bench_selected("job_parallel_for")) return;
+
+    int hardware_threads = (int)std::thread::hardware_concurrency();
+    if (hardware_threads < 1) hardware_threads = 1;
+    if (hardware_threads > JOB_MAX_THREADS) hardware_threads = JOB_MAX_THREADS;
+
+    JobContext jobs;
+    jobs.runs = new std::atomic<uint32_t>[BENCH_JOB_COUNT];
+    jobs.output = (uint32_t*)malloc(BENCH_JOB_COUNT * sizeof(uint32_t));
+
+    char name[96];
+    double single_thread_ns = 0.0;
+    for (int threads = 1;; threads *= 2) {
+        if (threads > hardware_threads) threads = hardware_threads;
+
+        jobs.system = new JobSystem();
+        job_system_init(jobs.system, threads);
+
+        // Exactly once: every index of one parallel_for (fine and coarse batches) runs one time
+        static const int batch_sizes[] = { 1, 64, 4096 };
+        for (int b = 0; b < 3; ++b) {
+            for (int i = 0; i < BENCH_JOB_COUNT; ++i) jobs.runs[i].store(0, std::memory_order_relaxed);
+            jobs.batch_size = batch_sizes[b];
+            bench_parallel_for(&jobs);
+
+            int wrong = 0;
+            for (int i = 0; i < BENCH_JOB_COUNT; ++i) {
+                if (jobs.runs[i].load(std::memory_order_relaxed) != 1) wrong++;
+            }
+            if (wrong) {
+                printf("  job system: %d of %d indices did not run exactly once (%d threads, batch %d)\n",
+                       wrong, BENCH_JOB_COUNT, threads, batch_sizes[b]);
+                bench_failed = true;
+            }
+        }
+
+        // Scaling (coarse batches) and scheduling overhead (one index per job)
+        jobs.batch_size = 4096;
+        snprintf(name, sizeof(name), "job_parallel_for/%d_threads", threads);
+        BenchResult* result = run_bench(name, bench_parallel_for, &jobs, BENCH_JOB_COUNT, "items");
+        if (result && threads == 1) single_thread_ns = result->median_ns;
+        if (result && threads > 1 && single_thread_ns > 0.0) {
+            printf("  job system: %.2fx speedup on %d threads\n", single_thread_ns / result->median_ns, threads);
+        }
+
+        jobs.batch_size = 1;
+        snprintf(name, sizeof(name), "job_parallel_for/batch_1/%d_threads", threads);
+        run_bench(name, bench_parallel_for, &jobs, BENCH_JOB_COUNT, "jobs");
+
+        job_system_shutdown(jobs.system);
+        delete jobs.system;
+        if (threads == hardware_threads) break;
+    }
+
+    delete[] jobs.runs;
+    free(jobs.output);
+}
+
+// ##################################################################
+//                          Results
+// ##################################################################
+
+static bool write_csv(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "benchmark,isa,median_ns,min_ns,items,unit\n");
+    for (int i = 0; i < result_count; ++i) {
+        BenchResult* result = &results[i];
+        fprintf(file, "%s,%s,%.3f,%.3f,%.0f,%s\n",
+                result->name, result->isa, result->median_ns, result->min_ns, result->items, result->unit);
+    }
+    fclose(file);
+    return true;
+}
+
+// Compares every result with the same benchmark + isa in the baseline. Returns the number of regressions.
+static int compare_with_baseline(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("Could not open baseline %s\n", path);
+        return -1;
+    }
+
+    int regressions = 0;
+    int matched = 0;
+    char line[256];
+    printf("\n%-46s %-7s %14s %14s %9s\n", "benchmark", "isa", "baseline ns", "current ns", "change");
+
+    while (fgets(line, sizeof(line), file)) {
+        BenchResult baseline;
+        if (sscanf(line, "%95[^,],%15[^,],%lf,%lf", baseline.name, baseline.isa,
+                   &baseline.median_ns, &baseline.min_ns) != 4) {
+            continue; // Header or malformed line
+        }
+
+        for (int i = 0; i < result_count; ++i) {
+            BenchResult* current = &results[i];
+            if (strcmp(current->name, baseline.name) || strcmp(current->isa, baseline.isa)) continue;
+
+            double change = (current->median_ns / baseline.median_ns - 1.0) * 100.0;
+            bool regressed = change > options.threshold_percent;
+            printf("%-46s %-7s %14.1f %14.1f %+8.1f%%%s\n", current->name, current->isa,
+                   baseline.median_ns, current->median_ns, change, regressed ? "  REGRESSION" : "");
+            if (regressed) regressions++;
+            matched++;
+            break;
+        }
+    }
+    fclose(file);
+
+    printf("%d benchmarks compared, %d regressed by more than %.1f%%\n", matched, regressions, options.threshold_percent);
+    return regressions;
+}
+
+// ##################################################################
+//                          Main
+// ##################################################################
+
+static void run_all_benchmarks() {
+    run_render_benchmarks();
+    run_raster_benchmarks();
+    run_asset_benchmarks();
+    run_audio_benchmarks();
+    run_text_benchmarks();
+    run_particle_benchmarks();
+    run_world_benchmarks();
+    run_rewind_benchmarks();
+    run_job_benchmarks();
+}
+
+static void print_usage() {
+    printf("usage: strangerBench [--isa NAME|all] [--filter TEXT] [--quick]\n"
+           "                     [--csv PATH] [--compare PATH] [--threshold PCT]\n");
+}
+
+int main(int argc, char** argv) {
+    options.threshold_percent = 10.0;
+    options.isa = CPU_ISA_AVX512;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : 0;
+
+        if (!strcmp(arg, "--quick")) {
+            options.quick = true;
+        } else if (!strcmp(arg, "--isa") && value) {
+            i++;
+            if (!strcmp(value, "all")) {
+                options.all_isas = true;
+            } else {
+                options.isa = cpu_isa_from_name(value);
+                if (options.isa == CPU_ISA_COUNT) {
+                    printf("Unknown ISA '%s'\n", value);
+                    return 2;
+                }
+            }
+        } else if (!strcmp(arg, "--filter") && value) {
+            options.filter = argv[++i];
+        } else if (!strcmp(arg, "--csv") && value) {
+            options.csv_path = argv[++i];
+        } else if (!strcmp(arg, "--compare") && value) {
+            options.compare_path = argv[++i];
+        } else if (!strcmp(arg, "--threshold") && value) {
+            options.threshold_percent = atof(argv[++i]);
+        } else {
+            print_usage();
+            return 2;
+        }
+    }
+
+    back_buffer_memory = (uint32_t*)calloc((size_t)BENCH_MAX_WIDTH * BENCH_MAX_HEIGHT, sizeof(uint32_t));
+    if (!back_buffer_memory) return 2;
+
+    printf("%-46s %-7s %17s %17s %17s\n", "benchmark", "isa", "median", "min", "throughput");
+
+    // Every level the CPU supports, or just the requested one (clamped like the game does)
+    CpuIsa best = cpu_best_isa(detect_cpu_features());
+    for (int level = CPU_ISA_SCALAR; level <= CPU_ISA_AVX512; ++level) {
+        if (options.all_isas ? level > best : level != (int)std::min(options.isa, best)) continue;
+
+        kernels_init((CpuIsa)level);
+        run_all_benchmarks();
+    }
+
+    int exit_code = bench_failed ? 2 : 0;
+    if (options.csv_path && !write_csv(options.csv_path)) {
+        printf("Could not write %s\n", options.csv_path);
+        exit_code = 2;
+    }
+    if (options.compare_path) {
+        int regressions = compare_with_baseline(options.compare_path);
+        if (regressions < 0) exit_code = 2;
+        else if (regressions > 0 && exit_code == 0) exit_code = 1;
+    }
+
+    free(back_buffer_memory);
+    return exit_code;
+}
@@ -0,0 +1,304 @@
+#include "audio_resampler.h"
+#include "kernels.h"
+
+#include <math.h>   // Required for sin, sqrt
+#include <stdlib.h> // Required for malloc
+
+// SSE2 is part of every x64 target, so the inner loop can rely on it there
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RESAMPLER_SSE2 1
+#include <emmintrin.h>
+#else
+#define RESAMPLER_SSE2 0
+#endif
+
+// Kaiser window shape: ~80 dB stopband attenuation for the 32-tap kernel
+#define RESAMPLER_KAISER_BETA 7.86
+
+// Fraction of the source Nyquist frequency kept when upsampling.
+// The transition band of a 32-tap kernel is wide, so we leave it some room.
+#define RESAMPLER_CUTOFF 0.84
+
+// Bits of the 32.32 fraction that are below the phase index
+#define RESAMPLER_FRACTION_BITS (32 - RESAMPLER_PHASE_BITS)
+
+// ##################################################################
+//                      Filter Table
+// ##################################################################
+
+static ResamplerBank global_resampler_banks[RESAMPLER_BANK_COUNT];
+
+// Zeroth-order modified Bessel function (power series), used by the Kaiser window
+static double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double half_x = x * 0.5;
+    for (int k = 1; k < 32; ++k) {
+        term *= half_x / (double)k;
+        sum += term * term;
+    }
+    return sum;
+}
+
+void resampler_init_tables() {
+    // Each bank lowers the cutoff so that reading the source up to max_ratio
+    // times faster than the output rate does not fold energy back as aliasing
+    static const float bank_ratios[RESAMPLER_BANK_COUNT] = { 1.0f, 1.5f, 2.0f, 3.0f, 4.0f };
+
+    const double pi = 3.14159265358979323846;
+    const double half_width = RESAMPLER_TAPS / 2;
+    const double window_scale = 1.0 / bessel_i0(RESAMPLER_KAISER_BETA);
+
+    for (int b = 0; b < RESAMPLER_BANK_COUNT; ++b) {
+        ResamplerBank* bank = &global_resampler_banks[b];
+        bank->max_ratio = bank_ratios[b];
+        double cutoff = RESAMPLER_CUTOFF / bank_ratios[b];
+
+        for (int p = 0; p <= RESAMPLER_PHASES; ++p) {
+            double fraction = (double)p / (double)RESAMPLER_PHASES;
+            double coefficients[RESAMPLER_TAPS];
+            double sum = 0.0;
+
+            for (int k = 0; k < RESAMPLER_TAPS; ++k) {
+                // Distance (in source samples) between this tap and the output position
+                double x = (double)(k - (RESAMPLER_TAPS / 2 - 1)) - fraction;
+
+                double sinc = cutoff;
+                if (x != 0.0) {
+                    sinc = sin(pi * cutoff * x) / (pi * x);
+                }
+
+                double w = x / half_width;
+                double window = 0.0;
+                if (w * w < 1.0) {
+                    window = bessel_i0(RESAMPLER_KAISER_BETA * sqrt(1.0 - w * w)) * window_scale;
+                }
+
+                coefficients[k] = sinc * window;
+                sum += coefficients[k];
+            }
+
+            // Normalize every phase to unity DC gain so a constant signal stays constant
+            for (int k = 0; k < RESAMPLER_TAPS; ++k) {
+                bank->coefficients[p][k] = (float)(coefficients[k] / sum);
+            }
+        }
+    }
+}
+
+// ##################################################################
+//                      Mixer
+// ##################################################################
+
+// Convolves one output frame for both channels.
+// The kernel is interpolated between the two nearest phases of the table.
+static inline void resampler_dot(const float* c0, const float* c1, float t,
+                                 const float* left, const float* right,
+                                 float* out_left, float* out_right) {
+#if RESAMPLER_SSE2
+    __m128 t4 = _mm_set1_ps(t);
+    __m128 sum_l = _mm_setzero_ps();
+    __m128 sum_r = _mm_setzero_ps();
+
+    for (int k = 0; k < RESAMPLER_TAPS; k += 4) {
+        __m128 a = _mm_loadu_ps(c0 + k);
+        __m128 b = _mm_loadu_ps(c1 + k);
+        __m128 c = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t4));
+
+        sum_l = _mm_add_ps(sum_l, _mm_mul_ps(c, _mm_loadu_ps(left + k)));
+        sum_r = _mm_add_ps(sum_r, _mm_mul_ps(c, _mm_loadu_ps(right + k)));
+    }
+
+    // Horizontal add: (l0 l1 l2 l3) (r0 r1 r2 r3) -> l, r
+    __m128 lo = _mm_unpacklo_ps(sum_l, sum_r); // l0 r0 l1 r1
+    __m128 hi = _mm_unpackhi_ps(sum_l, sum_r); // l2 r2 l3 r3
+    __m128 pair = _mm_add_ps(lo, hi);          // l02 r02 l13 r13
+    pair = _mm_add_ps(pair, _mm_movehl_ps(pair, pair));
+
+    float result[4];
+    _mm_storeu_ps(result, pair);
+    *out_left = result[0];
+    *out_right = result[1];
+#else
+    float sum_l = 0.0f;
+    float sum_r = 0.0f;
+    for (int k = 0; k < RESAMPLER_TAPS; ++k) {
+        float c = c0[k] + (c1[k] - c0[k]) * t;
+        sum_l += c * left[k];
+        sum_r += c * right[k];
+    }
+    *out_left = sum_l;
+    *out_right = sum_r;
+#endif
+}
+
+// Resamples a single voice into the output buffers
+static void mix_voice(PlayingSound* voice, float* left, float* right, uint32_t frame_count) {
+    LoadedSound* sound = voice->sound;
+    int source_count = (int)sound->sample_count;
+    uint64_t end = (uint64_t)sound->sample_count << 32;
+
+    // A one-shot keeps going for half a kernel past its last sample, so the filter
+    // rings out over the silence that follows instead of stopping mid-response (a click)
+    uint64_t tail_end = (uint64_t)(sound->sample_count + RESAMPLER_TAPS / 2) << 32;
+
+    // Scratch window for the taps that fall outside the asset (start, end, loop seam)
+    float window_l[RESAMPLER_TAPS];
+    float window_r[RESAMPLER_TAPS];
+
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        if (voice->looping) {
+            if (voice->position >= end) voice->position %= end;
+        } else if (voice->position >= tail_end) {
+            voice->active = false;
+            return;
+        }
+
+        uint32_t index = (uint32_t)(voice->position >> 32);
+        uint32_t fraction = (uint32_t)voice->position;
+
+        int phase = (int)(fraction >> RESAMPLER_FRACTION_BITS);
+        float t = (float)(fraction & ((1u << RESAMPLER_FRACTION_BITS) - 1)) *
+                  (1.0f / (float)(1u << RESAMPLER_FRACTION_BITS));
+
+        const float* c0 = voice->bank->coefficients[phase];
+        const float* c1 = voice->bank->coefficients[phase + 1];
+
+        int first = (int)index - (RESAMPLER_TAPS / 2 - 1);
+        const float* source_l = sound->samples[0] + first;
+        const float* source_r = sound->samples[1] + first;
+
+        if (first < 0 || first + RESAMPLER_TAPS > source_count) {
+            // Slow path: gather the taps one by one, wrapping or padding with silence
+            for (int k = 0; k < RESAMPLER_TAPS; ++k) {
+                int j = first + k;
+                if (voice->looping) {
+                    j %= source_count;
+                    if (j < 0) j += source_count;
+                } else if (j < 0 || j >= source_count) {
+                    window_l[k] = 0.0f;
+                    window_r[k] = 0.0f;
+                    continue;
+                }
+                window_l[k] = sound->samples[0][j];
+                window_r[k] = sound->samples[1][j];
+            }
+            source_l = window_l;
+            source_r = window_r;
+        }
+
+        float out_l, out_r;
+        resampler_dot(c0, c1, t, source_l, source_r, &out_l, &out_r);
+
+        left[i] += out_l * voice->volume[0];
+        right[i] += out_r * voice->volume[1];
+
+        voice->position += voice->step;
+    }
+}
+
+void mixer_set_pitch(SoundMixer* mixer, PlayingSound* voice, float pitch) {
+    if (pitch < 0.01f) pitch = 0.01f;
+    voice->pitch = pitch;
+
+    // Per-voice ratio: native rate conversion and pitch shift are the same operation
+    double ratio = (double)voice->sound->samples_per_second /
+                   (double)mixer->output_samples_per_second * (double)pitch;
+    voice->step = (uint64_t)(ratio * 4294967296.0 + 0.5);
+
+    // Pick the first bank whose cutoff is low enough for this ratio.
+    // Above the last bank a little aliasing is accepted.
+    voice->bank = &global_resampler_banks[RESAMPLER_BANK_COUNT - 1];
+    for (int b = 0; b < RESAMPLER_BANK_COUNT; ++b) {
+        if (ratio <= global_resampler_banks[b].max_ratio + 0.0001) {
+            voice->bank = &global_resampler_banks[b];
+            break;
+        }
+    }
+}
+
+PlayingSound* mixer_play_sound(SoundMixer* mixer, LoadedSound* sound, float volume, float pitch, bool looping) {
+    if (!sound || !sound->samples[0] || sound->sample_count == 0) return 0;
+
+    for (int v = 0; v < MIXER_MAX_VOICES; ++v) {
+        PlayingSound* voice = &mixer->voices[v];
+        if (!voice->active) {
+            voice->sound = sound;
+            voice->position = 0;
+            voice->volume[0] = volume;
+            voice->volume[1] = volume;
+            voice->looping = looping;
+            voice->active = true;
+            mixer_set_pitch(mixer, voice, pitch);
+            return voice;
+        }
+    }
+    return 0;
+}
+
+void mixer_mix_voices(SoundMixer* mixer, float* left, float* right, uint32_t frame_count) {
+    for (int v = 0; v < MIXER_MAX_VOICES; ++v) {
+        PlayingSound* voice = &mixer->voices[v];
+        if (voice->active) {
+            mix_voice(voice, left, right, frame_count);
+        }
+    }
+}
+
+void mixer_write_samples(SoundMixer* mixer, int16_t* sample_out, uint32_t sample_count,
+                         float* tone_phase, float tone_phase_step, float tone_volume) {
+    float mix_left[MIXER_CHUNK_FRAMES];
+    float mix_right[MIXER_CHUNK_FRAMES];
+
+    while (sample_count > 0) {
+        uint32_t chunk_count = sample_count;
+        if (chunk_count > MIXER_CHUNK_FRAMES) chunk_count = MIXER_CHUNK_FRAMES;
+
+        // Resamplear todas las voces activas a la frecuencia de salida
+        for (uint32_t i = 0; i < chunk_count; ++i) {
+            mix_left[i] = 0.0f;
+            mix_right[i] = 0.0f;
+        }
+        mixer_mix_voices(mixer, mix_left, mix_right, chunk_count);
+
+        // Tono de prueba + voces, saturado a int16 (kernel elegido según la CPU)
+        global_kernels.write_sound_samples(sample_out, mix_left, mix_right, chunk_count,
+                                           tone_phase, tone_phase_step, tone_volume);
+        sample_out += chunk_count * 2;
+        sample_count -= chunk_count;
+    }
+}
+
+// ##################################################################
+//                          Test Assets
+// ##################################################################
+
+LoadedSound make_test_sound(int samples_per_second, float seconds) {
+    const float two_pi = 6.28318530717958647692f;
+
+    LoadedSound sound = {};
+    sound.samples_per_second = samples_per_second;
+    sound.channel_count = 1;
+    sound.sample_count = (uint32_t)(samples_per_second * seconds);
+
+    // Mono: both channel pointers share the same data
+    sound.samples[0] = (float*)malloc(sound.sample_count * sizeof(float));
+    sound.samples[1] = sound.samples[0];
+    if (!sound.samples[0]) {
+        sound.sample_count = 0;
+        return sound;
+    }
+
+    float phase = 0.0f;
+    for (uint32_t i = 0; i < sound.sample_count; ++i) {
+        float t = (float)i / (float)sound.sample_count;
+        float frequency = 300.0f + 600.0f * t;      // Barrido de 300 Hz a 900 Hz
+        float envelope = (1.0f - t) * (1.0f - t);   // Caída suave
+
+        sound.samples[0][i] = sinf(phase) * envelope * 0.3f;
+
+        phase += two_pi * frequency / (float)samples_per_second;
+        if (phase > two_pi) phase -= two_pi;
+    }
+    return sound;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+// ##################################################################
+//                      Audio Resampler Types
+// ##################################################################
+
+// Length of the windowed-sinc kernel in source samples (multiple of 4 for SIMD)
+#define RESAMPLER_TAPS 32
+
+// Sub-sample positions stored in the filter table (2^RESAMPLER_PHASE_BITS)
+#define RESAMPLER_PHASE_BITS 7
+#define RESAMPLER_PHASES (1 << RESAMPLER_PHASE_BITS)
+
+// Filter banks with progressively lower cutoffs, used when a voice reads its
+// source faster than the output rate (downsampling or pitch up)
+#define RESAMPLER_BANK_COUNT 5
+
+// Maximum number of sounds the mixer can play at the same time
+#define MIXER_MAX_VOICES 32
+
+// Frames mixed per chunk by mixer_write_samples (keeps the float scratch buffers on the stack)
+#define MIXER_CHUNK_FRAMES 256
+
+// A sound asset decoded to planar float samples in [-1, 1]
+struct LoadedSound {
+    int samples_per_second;     // Native rate of the asset (22050, 44100, 48000...)
+    int channel_count;          // 1 (mono) or 2 (stereo)
+    uint32_t sample_count;      // Frames per channel
+    float* samples[2];          // Planar channel data (samples[1] == samples[0] for mono)
+};
+
+// One precomputed polyphase filter table
+// Row p holds the kernel centered at the fractional offset p / RESAMPLER_PHASES.
+// The extra row lets the mixer interpolate between adjacent phases without wrapping.
+struct ResamplerBank {
+    float max_ratio;            // Highest source/output ratio this bank stays alias-free for
+    float coefficients[RESAMPLER_PHASES + 1][RESAMPLER_TAPS];
+};
+
+// A voice: one instance of a sound being played by the mixer
+struct PlayingSound {
+    LoadedSound* sound;         // Asset being played
+    uint64_t position;          // Read position in source frames (32.32 fixed point)
+    uint64_t step;              // Source frames advanced per output frame (32.32 fixed point)
+    const ResamplerBank* bank;  // Filter bank matching the current step
+    float volume[2];            // Left / right gain
+    float pitch;                // 1.0 = original pitch
+    bool looping;               // Wrap around at the end instead of stopping
+    bool active;                // Voice slot in use
+};
+
+// Mixes every active voice to the output rate
+struct SoundMixer {
+    int output_samples_per_second;
+    PlayingSound voices[MIXER_MAX_VOICES];
+};
+
+// ##################################################################
+//                      Audio Resampler Functions
+// ##################################################################
+
+// Builds the windowed-sinc filter banks (call once before mixing)
+void resampler_init_tables();
+
+// Starts playing a sound on a free voice. Returns 0 if every voice is busy.
+PlayingSound* mixer_play_sound(SoundMixer* mixer, LoadedSound* sound, float volume, float pitch, bool looping);
+
+// Changes the playback rate of a voice (2.0 = one octave up)
+void mixer_set_pitch(SoundMixer* mixer, PlayingSound* voice, float pitch);
+
+// Resamples every active voice and ADDS the result to the left/right buffers
+void mixer_mix_voices(SoundMixer* mixer, float* left, float* right, uint32_t frame_count);
+
+// Generates sample_count interleaved stereo int16 frames: test tone + every active voice, saturated
+// tone_phase is the tone oscillator phase in radians (advanced by tone_phase_step per frame)
+void mixer_write_samples(SoundMixer* mixer, int16_t* sample_out, uint32_t sample_count,
+                         float* tone_phase, float tone_phase_step, float tone_volume);
+
+// Creates a procedural sound effect (rising chirp with a decaying envelope), allocated with malloc
+// Deliberately generated at a rate different from the output to exercise the resampler
+LoadedSound make_test_sound(int samples_per_second, float seconds);
@@ -0,0 +1,223 @@
+#include "bmp.h"
+#include "kernels.h"
+
+#include <stdlib.h> // Required for malloc, free
+
+// File header: "BM", file size, 2 reserved words, pixel data offset
+#define BMP_FILE_HEADER_SIZE 14
+
+// Compression values used by the supported formats
+#define BMP_BI_RGB 0
+#define BMP_BI_BITFIELDS 3
+#define BMP_BI_ALPHABITFIELDS 6
+
+// ##################################################################
+//                          Header Parsing
+// ##################################################################
+
+// File data is little-endian and unaligned: always read byte by byte
+static uint16_t read_u16(const uint8_t* bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static uint32_t read_u32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+// A channel described by a BI_BITFIELDS mask
+struct BmpChannel {
+    uint32_t mask;
+    int shift;      // Position of the lowest mask bit
+    int bits;       // Width of the mask (0 = channel not present)
+};
+
+// Returns false if the mask is not one contiguous run of bits
+static bool make_channel(uint32_t mask, BmpChannel* channel) {
+    channel->mask = mask;
+    channel->shift = 0;
+    channel->bits = 0;
+    if (mask == 0) return true;
+
+    while (!((mask >> channel->shift) & 1)) channel->shift++;
+    uint32_t run = mask >> channel->shift;
+    while (channel->bits < 32 && ((run >> channel->bits) & 1)) channel->bits++;
+
+    // Any bit left above the run means a hole in the mask
+    return channel->bits == 32 || (run >> channel->bits) == 0;
+}
+
+// Extracts a channel and rescales it to 8 bits (missing channels read as `missing`)
+static uint32_t extract_channel(uint32_t pixel, const BmpChannel* channel, uint32_t missing) {
+    if (channel->bits == 0) return missing;
+
+    uint32_t value = (pixel & channel->mask) >> channel->shift;
+    if (channel->bits >= 8) return value >> (channel->bits - 8);
+
+    uint32_t max_value = (1u << channel->bits) - 1;
+    return (value * 255 + max_value / 2) / max_value;
+}
+
+// ##################################################################
+//                          Decoder
+// ##################################################################
+
+// Row y of the output (top-down) is file row y, or height - 1 - y for bottom-up files
+static const uint8_t* file_row(const uint8_t* pixel_data, uint64_t stride, int64_t height, bool top_down, int64_t y) {
+    return pixel_data + stride * (uint64_t)(top_down ? y : height - 1 - y);
+}
+
+BmpError bmp_decode(const void* data, size_t size, LoadedBitmap* result) {
+    const uint8_t* file = (const uint8_t*)data;
+    result->width = 0;
+    result->height = 0;
+    result->pixels = 0;
+
+    // --- Headers ---
+    if (!file || size < BMP_FILE_HEADER_SIZE + 4) return BMP_ERROR_TRUNCATED;
+    if (file[0] != 'B' || file[1] != 'M') return BMP_ERROR_NOT_BMP;
+
+    uint32_t pixel_offset = read_u32(file + 10);
+    const uint8_t* info = file + BMP_FILE_HEADER_SIZE;
+    uint32_t header_size = read_u32(info);
+
+    // BITMAPINFOHEADER (40), V2 (52), V3 (56), V4 (108), V5 (124)
+    if (header_size != 40 && header_size != 52 && header_size != 56 && header_size != 108 && header_size != 124) {
+        return BMP_ERROR_UNSUPPORTED_HEADER;
+    }
+    if (size < BMP_FILE_HEADER_SIZE + (size_t)header_size) return BMP_ERROR_TRUNCATED;
+
+    int64_t width = (int32_t)read_u32(info + 4);
+    int64_t height = (int32_t)read_u32(info + 8);     // Negative = rows stored top-down
+    uint16_t planes = read_u16(info + 12);
+    uint16_t bits_per_pixel = read_u16(info + 14);
+    uint32_t compression = read_u32(info + 16);
+
+    bool top_down = height < 0;
+    if (top_down) height = -height;
+    if (width <= 0 || height == 0 || width > BMP_MAX_DIMENSION || height > BMP_MAX_DIMENSION) {
+        return BMP_ERROR_BAD_DIMENSIONS;
+    }
+    if (planes != 1) return BMP_ERROR_UNSUPPORTED_FORMAT;
+
+    // --- Pixel format ---
+    uint32_t masks[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }; // R, G, B, A
+    bool alpha_if_present = false;  // BI_RGB 32-bit: the 4th byte is alpha only if some pixel uses it
+
+    if (bits_per_pixel == 24) {
+        if (compression != BMP_BI_RGB) return BMP_ERROR_UNSUPPORTED_FORMAT;
+    } else if (bits_per_pixel == 32) {
+        if (compression == BMP_BI_RGB) {
+            alpha_if_present = true;
+        } else if (compression == BMP_BI_BITFIELDS || compression == BMP_BI_ALPHABITFIELDS) {
+            int mask_count = (compression == BMP_BI_ALPHABITFIELDS) ? 4 : 3;
+            const uint8_t* mask_bytes = info + 40;
+
+            if (header_size >= 56) {
+                mask_count = 4;     // V3+ headers always carry the alpha mask
+            } else if (header_size == 40 &&
+                       size < BMP_FILE_HEADER_SIZE + (size_t)header_size + 4 * (size_t)mask_count) {
+                return BMP_ERROR_TRUNCATED; // Masks follow a plain BITMAPINFOHEADER
+            } else if (header_size == 52) {
+                mask_count = 3;
+            }
+
+            masks[3] = 0;
+            for (int i = 0; i < mask_count; ++i) {
+                masks[i] = read_u32(mask_bytes + 4 * i);
+            }
+        } else {
+            return BMP_ERROR_UNSUPPORTED_FORMAT;
+        }
+    } else {
+        return BMP_ERROR_UNSUPPORTED_FORMAT;
+    }
+
+    BmpChannel channels[4];
+    for (int i = 0; i < 4; ++i) {
+        if (!make_channel(masks[i], &channels[i])) return BMP_ERROR_BAD_MASKS;
+    }
+    if (!masks[0] || !masks[1] || !masks[2]) return BMP_ERROR_BAD_MASKS;
+    if ((masks[0] & masks[1]) || (masks[0] & masks[2]) || (masks[1] & masks[2]) ||
+        ((masks[0] | masks[1] | masks[2]) & masks[3])) {
+        return BMP_ERROR_BAD_MASKS;
+    }
+
+    // --- Pixel data bounds (64-bit math: no overflow with the dimension limit) ---
+    uint64_t row_bytes = (uint64_t)width * (bits_per_pixel / 8);
+    uint64_t stride = ((uint64_t)width * bits_per_pixel + 31) / 32 * 4;   // Rows are padded to 4 bytes
+    if (pixel_offset < BMP_FILE_HEADER_SIZE + (uint64_t)header_size) return BMP_ERROR_BAD_OFFSET;
+    if ((uint64_t)pixel_offset + stride * (uint64_t)(height - 1) + row_bytes > size) return BMP_ERROR_TRUNCATED;
+
+    const uint8_t* pixel_data = file + pixel_offset;
+
+    // --- Conversion ---
+    uint32_t* pixels = (uint32_t*)malloc((size_t)(width * height) * sizeof(uint32_t));
+    if (!pixels) return BMP_ERROR_OUT_OF_MEMORY;
+
+    bool native_masks = masks[0] == 0x00FF0000 && masks[1] == 0x0000FF00 &&
+                        masks[2] == 0x000000FF && masks[3] == 0xFF000000;
+
+    for (int64_t y = 0; y < height; ++y) {
+        const uint8_t* source_row = file_row(pixel_data, stride, height, top_down, y);
+        uint32_t* dest_row = pixels + y * width;
+
+        if (bits_per_pixel == 24) {
+            // B, G, R -> opaque ARGB (best kernel for this CPU)
+            global_kernels.expand_bgr_pixels(dest_row, source_row, (int)width);
+        } else if (alpha_if_present) {
+            // Many tools write 32-bit BI_RGB with the 4th byte left at zero: that means opaque, not invisible.
+            // Decode as opaque while every 4th byte so far is zero; the first nonzero one means the file
+            // has alpha after all, so the rows done so far are redone premultiplied (one row, usually)
+            if (global_kernels.expand_bgrx_pixels(dest_row, source_row, (int)width)) {
+                for (int64_t done = 0; done <= y; ++done) {
+                    global_kernels.premultiply_pixels(pixels + done * width,
+                                                      file_row(pixel_data, stride, height, top_down, done), (int)width);
+                }
+                alpha_if_present = false;
+            }
+        } else if (native_masks) {
+            // Already B, G, R, A in memory: only the premultiply is left
+            global_kernels.premultiply_pixels(dest_row, source_row, (int)width);
+        } else {
+            // Arbitrary masks: extract each channel, then premultiply in place
+            for (int64_t x = 0; x < width; ++x) {
+                uint32_t pixel = read_u32(source_row + 4 * x);
+                dest_row[x] = (extract_channel(pixel, &channels[3], 255) << 24) |
+                              (extract_channel(pixel, &channels[0], 0) << 16) |
+                              (extract_channel(pixel, &channels[1], 0) << 8) |
+                              extract_channel(pixel, &channels[2], 0);
+            }
+            if (masks[3]) {
+                global_kernels.premultiply_pixels(dest_row, (const uint8_t*)dest_row, (int)width);
+            }
+        }
+    }
+
+    result->width = (int)width;
+    result->height = (int)height;
+    result->pixels = pixels;
+    return BMP_OK;
+}
+
+void bmp_free(LoadedBitmap* bitmap) {
+    free(bitmap->pixels);
+    bitmap->pixels = 0;
+    bitmap->width = 0;
+    bitmap->height = 0;
+}
+
+const char* bmp_error_name(BmpError error) {
+    static const char* names[BMP_ERROR_COUNT] = {
+        "ok",
+        "file is truncated",
+        "not a BMP file",
+        "unsupported info header",
+        "bad dimensions",
+        "pixel data offset inside the headers",
+        "unsupported pixel format",
+        "bad channel masks",
+        "out of memory",
+    };
+    if (error < 0 || error >= BMP_ERROR_COUNT) return "unknown error";
+    return names[error];
+}
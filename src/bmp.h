@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "render.h"
+
+// ##################################################################
+//                          BMP Decoder Types
+// ##################################################################
+//
+// Decodes an in-memory .bmp file into the engine's native layout:
+// top-down, premultiplied ARGB, pitch = width. Everything the renderer
+// needs is done here once, so bitmaps are drawn with no per-frame fixups.
+//
+// Supported: BITMAPINFOHEADER and V2-V5 headers; 24-bit BI_RGB; 32-bit
+// BI_RGB, BI_BITFIELDS and BI_ALPHABITFIELDS; bottom-up and top-down rows.
+// Every header field is validated against the buffer size before use.
+
+// Largest accepted width/height (keeps every size computation far from overflow)
+#define BMP_MAX_DIMENSION 16384
+
+enum BmpError {
+    BMP_OK,
+    BMP_ERROR_TRUNCATED,            // Buffer ends before the headers or the pixel rows
+    BMP_ERROR_NOT_BMP,              // Missing "BM" signature
+    BMP_ERROR_UNSUPPORTED_HEADER,   // Info header size is not a known version (e.g. OS/2 core header)
+    BMP_ERROR_BAD_DIMENSIONS,       // Zero, negative width or larger than BMP_MAX_DIMENSION
+    BMP_ERROR_BAD_OFFSET,           // Pixel data offset points inside the headers
+    BMP_ERROR_UNSUPPORTED_FORMAT,   // Bit depth / compression combination not handled
+    BMP_ERROR_BAD_MASKS,            // Channel masks empty, not contiguous or overlapping
+    BMP_ERROR_OUT_OF_MEMORY,
+    BMP_ERROR_COUNT
+};
+
+// ##################################################################
+//                          BMP Decoder Functions
+// ##################################################################
+
+// Decodes a whole .bmp file. On success result->pixels is allocated with malloc (free with bmp_free).
+// On failure result is left empty.
+BmpError bmp_decode(const void* data, size_t size, LoadedBitmap* result);
+
+// Releases the pixels of a decoded bitmap
+void bmp_free(LoadedBitmap* bitmap);
+
+// Short description of an error, for logs
+const char* bmp_error_name(BmpError error);
@@ -0,0 +1,91 @@
+#include "cpu_features.h"
+
+#include <stdint.h>
+#include <string.h> // Required for strcmp
+
+#if CPU_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h> // _xgetbv
+
+static void cpuid(int leaf, int subleaf, uint32_t regs[4]) {
+    int info[4];
+    __cpuidex(info, leaf, subleaf);
+    for (int i = 0; i < 4; ++i) regs[i] = (uint32_t)info[i];
+}
+
+static uint64_t read_xcr0() {
+    return _xgetbv(0);
+}
+#else
+#include <cpuid.h>
+
+static void cpuid(int leaf, int subleaf, uint32_t regs[4]) {
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+}
+
+static uint64_t read_xcr0() {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+#endif
+#endif // CPU_X86
+
+CpuFeatures detect_cpu_features() {
+    CpuFeatures features = {};
+
+#if CPU_X86
+    uint32_t regs[4]; // eax, ebx, ecx, edx
+
+    cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    features.sse2 = (regs[3] & (1u << 26)) != 0;
+    features.sse41 = (regs[2] & (1u << 19)) != 0;
+
+    // AVX registers are only usable if the OS saves them on context switches
+    bool os_xsave = (regs[2] & (1u << 27)) != 0;
+    bool cpu_avx = (regs[2] & (1u << 28)) != 0;
+    uint64_t xcr0 = os_xsave ? read_xcr0() : 0;
+    bool os_ymm = (xcr0 & 0x06) == 0x06;    // SSE + AVX state
+    bool os_zmm = (xcr0 & 0xE6) == 0xE6;    // + opmask, ZMM0-15 upper, ZMM16-31
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        bool cpu_avx2 = (regs[1] & (1u << 5)) != 0;
+        bool cpu_avx512f = (regs[1] & (1u << 16)) != 0;
+        bool cpu_avx512bw = (regs[1] & (1u << 30)) != 0;
+
+        features.avx2 = cpu_avx && cpu_avx2 && os_ymm;
+        features.avx512 = features.avx2 && cpu_avx512f && cpu_avx512bw && os_zmm;
+    }
+#endif
+
+    return features;
+}
+
+CpuIsa cpu_best_isa(CpuFeatures features) {
+    if (features.avx512) return CPU_ISA_AVX512;
+    if (features.avx2) return CPU_ISA_AVX2;
+    if (features.sse41) return CPU_ISA_SSE41;
+    if (features.sse2) return CPU_ISA_SSE2;
+    return CPU_ISA_SCALAR;
+}
+
+static const char* isa_names[CPU_ISA_COUNT] = {
+    "scalar", "sse2", "sse41", "avx2", "avx512"
+};
+
+const char* cpu_isa_name(CpuIsa isa) {
+    if (isa < 0 || isa >= CPU_ISA_COUNT) return "unknown";
+    return isa_names[isa];
+}
+
+CpuIsa cpu_isa_from_name(const char* name) {
+    for (int i = 0; i < CPU_ISA_COUNT; ++i) {
+        if (strcmp(name, isa_names[i]) == 0) return (CpuIsa)i;
+    }
+    return CPU_ISA_COUNT;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// ##################################################################
+//                      CPU Feature Detection
+// ##################################################################
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_X86 1
+#else
+#define CPU_X86 0
+#endif
+
+// Instruction set levels, in increasing order of capability
+// A level implies every level below it.
+enum CpuIsa {
+    CPU_ISA_SCALAR,     // Plain C++, runs anywhere
+    CPU_ISA_SSE2,       // 128-bit integer + float (x64 baseline)
+    CPU_ISA_SSE41,      // SSE4.1 (+SSSE3 shuffles, blendv)
+    CPU_ISA_AVX2,       // 256-bit integer
+    CPU_ISA_AVX512,     // AVX-512 F + BW (512-bit integer with byte/word ops)
+    CPU_ISA_COUNT
+};
+
+// What the processor AND the operating system support
+struct CpuFeatures {
+    bool sse2;
+    bool sse41;
+    bool avx2;          // Also requires OS support for YMM state
+    bool avx512;        // F + BW, also requires OS support for ZMM state
+};
+
+// Queries CPUID/XGETBV (all false on non-x86 targets)
+CpuFeatures detect_cpu_features();
+
+// Highest level the machine can run
+CpuIsa cpu_best_isa(CpuFeatures features);
+
+// Short lowercase name ("scalar", "sse2", "sse41", "avx2", "avx512")
+const char* cpu_isa_name(CpuIsa isa);
+
+// Parses a name as returned by cpu_isa_name. Returns CPU_ISA_COUNT if unknown.
+CpuIsa cpu_isa_from_name(const char* name);
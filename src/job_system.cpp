@@ -0,0 +1,234 @@
+#include "job_system.h"
+
+// Index of the current thread, set once when it joins the system
+static thread_local int current_thread_index = -1;
+
+int job_thread_index() {
+    return current_thread_index;
+}
+
+// ##################################################################
+//                      Work-Stealing Deque
+// ##################################################################
+
+static void write_slot(JobSlot* slot, const Job* job) {
+    slot->function.store(job->function, std::memory_order_relaxed);
+    slot->data.store(job->data, std::memory_order_relaxed);
+    slot->begin.store(job->begin, std::memory_order_relaxed);
+    slot->end.store(job->end, std::memory_order_relaxed);
+    slot->counter.store(job->counter, std::memory_order_relaxed);
+}
+
+static void read_slot(JobSlot* slot, Job* job) {
+    job->function = slot->function.load(std::memory_order_relaxed);
+    job->data = slot->data.load(std::memory_order_relaxed);
+    job->begin = slot->begin.load(std::memory_order_relaxed);
+    job->end = slot->end.load(std::memory_order_relaxed);
+    job->counter = slot->counter.load(std::memory_order_relaxed);
+}
+
+// Owner only. Returns false when the deque is full.
+static bool deque_push(JobDeque* deque, const Job* job) {
+    int64_t b = deque->bottom.load(std::memory_order_relaxed);
+    int64_t t = deque->top.load(std::memory_order_acquire);
+    if (b - t >= JOB_DEQUE_CAPACITY) return false;
+
+    // Release: a thief that sees the new bottom also sees the slot contents
+    write_slot(&deque->slots[b & (JOB_DEQUE_CAPACITY - 1)], job);
+    deque->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+// Owner only: takes the most recently pushed job (LIFO keeps caches warm)
+static bool deque_pop(JobDeque* deque, Job* job) {
+    int64_t b = deque->bottom.load(std::memory_order_relaxed) - 1;
+    deque->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = deque->top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // Empty
+        deque->bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    read_slot(&deque->slots[b & (JOB_DEQUE_CAPACITY - 1)], job);
+    if (t == b) {
+        // Last job: race against thieves for it
+        bool won = deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        deque->bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+// Any thread: takes the oldest job
+static bool deque_steal(JobDeque* deque, Job* job) {
+    int64_t t = deque->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = deque->bottom.load(std::memory_order_acquire);
+    if (t >= b) return false;
+
+    read_slot(&deque->slots[t & (JOB_DEQUE_CAPACITY - 1)], job);
+    return deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+// ##################################################################
+//                          Scheduling
+// ##################################################################
+
+static void run_job(JobSystem* system, JobDeque* deque, Job* job) {
+    system->pending_jobs.fetch_sub(1, std::memory_order_relaxed);
+    job->function(job->data, job->begin, job->end);
+    deque->jobs_executed.fetch_add(1, std::memory_order_relaxed);
+
+    if (job->counter) {
+        job->counter->value.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+// Tries the own deque first, then steals from the others. Returns false if no job was found.
+static bool try_run_one_job(JobSystem* system, int thread_index, uint32_t* random_state) {
+    JobDeque* own = system->deques[thread_index];
+    Job job;
+
+    if (deque_pop(own, &job)) {
+        run_job(system, own, &job);
+        return true;
+    }
+
+    // Start at a random victim so thieves do not all hammer the same deque
+    *random_state ^= *random_state << 13;
+    *random_state ^= *random_state >> 17;
+    *random_state ^= *random_state << 5;
+    int start = (int)(*random_state % (uint32_t)system->thread_count);
+
+    for (int i = 0; i < system->thread_count; ++i) {
+        int victim = (start + i) % system->thread_count;
+        if (victim == thread_index) continue;
+
+        if (deque_steal(system->deques[victim], &job)) {
+            own->jobs_stolen.fetch_add(1, std::memory_order_relaxed);
+            run_job(system, own, &job);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void worker_main(JobSystem* system, int thread_index) {
+    current_thread_index = thread_index;
+    uint32_t random_state = 0x9E3779B9u * (uint32_t)(thread_index + 1);
+
+    for (;;) {
+        if (try_run_one_job(system, thread_index, &random_state)) continue;
+
+        // Short spin before sleeping: new jobs usually arrive in bursts
+        bool found = false;
+        for (int spin = 0; spin < 64 && !found; ++spin) {
+            std::this_thread::yield();
+            found = try_run_one_job(system, thread_index, &random_state);
+        }
+        if (found) continue;
+
+        std::unique_lock<std::mutex> lock(system->sleep_mutex);
+        system->sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+        while (system->pending_jobs.load(std::memory_order_seq_cst) == 0 &&
+               !system->quitting.load(std::memory_order_relaxed)) {
+            system->wake_up.wait(lock);
+        }
+        system->sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+
+        if (system->quitting.load(std::memory_order_relaxed) &&
+            system->pending_jobs.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+// ##################################################################
+//                          Public API
+// ##################################################################
+
+void job_system_init(JobSystem* system, int thread_count) {
+    if (thread_count <= 0) {
+        thread_count = (int)std::thread::hardware_concurrency();
+        if (thread_count <= 0) thread_count = 1;
+    }
+    if (thread_count > JOB_MAX_THREADS) thread_count = JOB_MAX_THREADS;
+
+    system->thread_count = thread_count;
+    system->pending_jobs.store(0);
+    system->sleeping_workers.store(0);
+    system->quitting.store(false);
+
+    for (int i = 0; i < thread_count; ++i) {
+        system->deques[i] = new JobDeque();
+    }
+
+    current_thread_index = 0;
+    for (int i = 1; i < thread_count; ++i) {
+        system->workers[i] = std::thread(worker_main, system, i);
+    }
+}
+
+void job_system_shutdown(JobSystem* system) {
+    {
+        std::lock_guard<std::mutex> lock(system->sleep_mutex);
+        system->quitting.store(true);
+    }
+    system->wake_up.notify_all();
+
+    for (int i = 1; i < system->thread_count; ++i) {
+        system->workers[i].join();
+    }
+    for (int i = 0; i < system->thread_count; ++i) {
+        delete system->deques[i];
+        system->deques[i] = nullptr;
+    }
+    system->thread_count = 0;
+}
+
+void job_submit(JobSystem* system, job_function* function, void* data, int begin, int end, JobCounter* counter) {
+    Job job = { function, data, begin, end, counter };
+    if (counter) counter->value.fetch_add(1, std::memory_order_relaxed);
+
+    int thread_index = current_thread_index;
+    system->pending_jobs.fetch_add(1, std::memory_order_seq_cst);
+
+    if (thread_index < 0 || !deque_push(system->deques[thread_index], &job)) {
+        // Foreign thread or full deque: run it right here
+        run_job(system, system->deques[thread_index < 0 ? 0 : thread_index], &job);
+        return;
+    }
+
+    // Wake a sleeper (the lock pairs with the predicate check in worker_main)
+    if (system->sleeping_workers.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(system->sleep_mutex); }
+        system->wake_up.notify_one();
+    }
+}
+
+void job_wait(JobSystem* system, JobCounter* counter) {
+    int thread_index = current_thread_index;
+    uint32_t random_state = 0x2545F491u;
+
+    while (counter->value.load(std::memory_order_acquire) > 0) {
+        if (thread_index < 0 || !try_run_one_job(system, thread_index, &random_state)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void job_parallel_for(JobSystem* system, job_function* function, void* data, int count, int batch_size) {
+    if (count <= 0) return;
+    if (batch_size <= 0) batch_size = 1;
+
+    JobCounter counter;
+    for (int begin = 0; begin < count; begin += batch_size) {
+        int end = begin + batch_size;
+        if (end > count) end = count;
+        job_submit(system, function, data, begin, end, &counter);
+    }
+    job_wait(system, &counter);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// ##################################################################
+//                          Job System Types
+// ##################################################################
+//
+// One worker thread per core, each with a work-stealing deque.
+// The thread that calls job_system_init becomes thread 0 and owns a deque
+// too: it submits work and helps run jobs while it waits on a counter.
+
+// Jobs per deque (power of two). A full deque runs new jobs inline.
+#define JOB_DEQUE_CAPACITY 4096
+
+// Upper bound on threads (including the main thread)
+#define JOB_MAX_THREADS 64
+
+// Work function: data is user-owned, [begin, end) is the range for this job
+typedef void job_function(void* data, int begin, int end);
+
+// Dependency counter: submitting a job adds 1, finishing it subtracts 1.
+// job_wait returns when it reaches zero.
+struct JobCounter {
+    std::atomic<int> value{0};
+};
+
+// One deque slot. Fields are atomics (relaxed) so a thief racing with the
+// owner never performs a torn non-atomic read; a losing thief discards it.
+struct JobSlot {
+    std::atomic<job_function*> function{nullptr};
+    std::atomic<void*> data{nullptr};
+    std::atomic<int> begin{0};
+    std::atomic<int> end{0};
+    std::atomic<JobCounter*> counter{nullptr};
+};
+
+// A job taken out of a deque
+struct Job {
+    job_function* function;
+    void* data;
+    int begin;
+    int end;
+    JobCounter* counter;
+};
+
+// Chase-Lev deque: the owner pushes/pops at the bottom, thieves steal from the top
+struct JobDeque {
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<uint64_t> jobs_executed{0}; // Stats: jobs run by this thread
+    std::atomic<uint64_t> jobs_stolen{0};               // Stats: jobs this thread stole
+    JobSlot slots[JOB_DEQUE_CAPACITY];
+};
+
+struct JobSystem {
+    int thread_count;                   // Workers + the main thread
+    JobDeque* deques[JOB_MAX_THREADS];  // deques[0] belongs to the main thread
+    std::thread workers[JOB_MAX_THREADS];
+
+    // Sleeping for idle workers
+    std::atomic<int> pending_jobs{0};   // Jobs sitting in any deque
+    std::atomic<int> sleeping_workers{0};
+    std::atomic<bool> quitting{false};
+    std::mutex sleep_mutex;
+    std::condition_variable wake_up;
+};
+
+// ##################################################################
+//                          Job System Functions
+// ##################################################################
+
+// Starts thread_count - 1 workers (0 = one thread per hardware core)
+void job_system_init(JobSystem* system, int thread_count);
+
+// Stops and joins the workers (pending jobs are finished first)
+void job_system_shutdown(JobSystem* system);
+
+// Queues a job on the calling thread's deque. Must be called from the main thread or a job.
+void job_submit(JobSystem* system, job_function* function, void* data, int begin, int end, JobCounter* counter);
+
+// Runs jobs until the counter reaches zero (the waiting thread is never idle)
+void job_wait(JobSystem* system, JobCounter* counter);
+
+// Splits [0, count) into batches of batch_size, runs them in parallel and waits
+void job_parallel_for(JobSystem* system, job_function* function, void* data, int count, int batch_size);
+
+// Index of the calling thread in the system (0 = main thread, -1 = foreign thread)
+int job_thread_index();
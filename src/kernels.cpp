@@ -0,0 +1,188 @@
+#include "kernels.h"
+#include "kernels_internal.h"
+
+#include <math.h>   // Required for sinf
+
+// ##################################################################
+//                      Scalar Kernels
+// ##################################################################
+
+static void fill_pixels_scalar(uint8_t* dest_row, int dest_pitch, int width, int height, uint32_t color) {
+    for (int y = 0; y < height; ++y) {
+        uint32_t* pixel = (uint32_t*)dest_row;
+        for (int x = 0; x < width; ++x) {
+            *pixel++ = color;
+        }
+        dest_row += dest_pitch;
+    }
+}
+
+static void copy_pixels_scalar(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                               int width, int height) {
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        const uint32_t* source_pixel = source_row;
+        for (int x = 0; x < width; ++x) {
+            *dest_pixel++ = *source_pixel++;
+        }
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void blend_pixels_scalar(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                                int width, int height) {
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        const uint32_t* source_pixel = source_row;
+
+        for (int x = 0; x < width; ++x) {
+            *dest_pixel = blend_pixel(*source_pixel, *dest_pixel);
+            dest_pixel++;
+            source_pixel++;
+        }
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void add_pixels_scalar(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                              int width, int height) {
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        const uint32_t* source_pixel = source_row;
+
+        for (int x = 0; x < width; ++x) {
+            *dest_pixel = add_pixel(*source_pixel, *dest_pixel);
+            dest_pixel++;
+            source_pixel++;
+        }
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void premultiply_pixels_scalar(uint32_t* dest, const uint8_t* source, int count) {
+    for (int i = 0; i < count; ++i) {
+        dest[i] = premultiply_pixel(source + 4 * i);
+    }
+}
+
+static void expand_bgr_pixels_scalar(uint32_t* dest, const uint8_t* source, int count) {
+    for (int i = 0; i < count; ++i) {
+        const uint8_t* bgr = source + 3 * i;
+        dest[i] = 0xFF000000 | ((uint32_t)bgr[2] << 16) | ((uint32_t)bgr[1] << 8) | bgr[0];
+    }
+}
+
+static bool expand_bgrx_pixels_scalar(uint32_t* dest, const uint8_t* source, int count) {
+    uint32_t fourth_bytes = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint8_t* bgrx = source + 4 * i;
+        fourth_bytes |= bgrx[3];
+        dest[i] = 0xFF000000 | ((uint32_t)bgrx[2] << 16) | ((uint32_t)bgrx[1] << 8) | bgrx[0];
+    }
+    return fourth_bytes != 0;
+}
+
+static void write_sound_samples_scalar(int16_t* sample_out, const float* mix_left, const float* mix_right,
+                                       uint32_t sample_count, float* phase, float phase_step, float tone_volume) {
+    float t = *phase;
+
+    for (uint32_t i = 0; i < sample_count; ++i) {
+        float sine_value = sinf(t) * tone_volume;
+
+        // Saturate so several loud voices do not wrap around
+        *sample_out++ = saturate_sample(sine_value + mix_left[i] * 32767.0f);
+        *sample_out++ = saturate_sample(sine_value + mix_right[i] * 32767.0f);
+
+        t += phase_step;
+        if (t > KERNELS_TWO_PI) t -= KERNELS_TWO_PI;
+    }
+
+    *phase = t;
+}
+
+static void update_particles_scalar(float* pos_x, float* pos_y, float* vel_x, float* vel_y, float* life,
+                                    int count, float dt, float gravity) {
+    for (int i = 0; i < count; ++i) {
+        update_particle(pos_x + i, pos_y + i, vel_x + i, vel_y + i, life + i, dt, gravity);
+    }
+}
+
+static void fill_edges_scalar(uint8_t* dest_row, int dest_pitch, int width, int height,
+                              const RasterEdges* edges, uint32_t color) {
+    int32_t e0_row = edges->origin[0];
+    int32_t e1_row = edges->origin[1];
+    int32_t e2_row = edges->origin[2];
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* pixel = (uint32_t*)dest_row;
+        int32_t e0 = e0_row;
+        int32_t e1 = e1_row;
+        int32_t e2 = e2_row;
+
+        for (int x = 0; x < width; ++x) {
+            // Inside when no edge is negative (sign bit of the OR)
+            if ((e0 | e1 | e2) >= 0) pixel[x] = color;
+            e0 += edges->step_x[0];
+            e1 += edges->step_x[1];
+            e2 += edges->step_x[2];
+        }
+
+        e0_row += edges->step_y[0];
+        e1_row += edges->step_y[1];
+        e2_row += edges->step_y[2];
+        dest_row += dest_pitch;
+    }
+}
+
+EngineKernels global_kernels = {
+    CPU_ISA_SCALAR,
+    fill_pixels_scalar,
+    copy_pixels_scalar,
+    blend_pixels_scalar,
+    add_pixels_scalar,
+    premultiply_pixels_scalar,
+    expand_bgr_pixels_scalar,
+    expand_bgrx_pixels_scalar,
+    write_sound_samples_scalar,
+    update_particles_scalar,
+    fill_edges_scalar
+};
+
+void kernels_bind_scalar(EngineKernels* table) {
+    table->isa = CPU_ISA_SCALAR;
+    table->fill_pixels = fill_pixels_scalar;
+    table->copy_pixels = copy_pixels_scalar;
+    table->blend_pixels = blend_pixels_scalar;
+    table->add_pixels = add_pixels_scalar;
+    table->premultiply_pixels = premultiply_pixels_scalar;
+    table->expand_bgr_pixels = expand_bgr_pixels_scalar;
+    table->expand_bgrx_pixels = expand_bgrx_pixels_scalar;
+    table->write_sound_samples = write_sound_samples_scalar;
+    table->update_particles = update_particles_scalar;
+    table->fill_edges = fill_edges_scalar;
+}
+
+// ##################################################################
+//                      Dispatch
+// ##################################################################
+
+void kernels_build_table(EngineKernels* table, CpuIsa isa) {
+    // Layered: each level starts from the table of the level below
+    kernels_bind_scalar(table);
+    if (isa >= CPU_ISA_SSE2) kernels_bind_sse2(table);
+    if (isa >= CPU_ISA_SSE41) kernels_bind_sse41(table);
+    if (isa >= CPU_ISA_AVX2) kernels_bind_avx2(table);
+    if (isa >= CPU_ISA_AVX512) kernels_bind_avx512(table);
+    table->isa = isa;
+}
+
+CpuIsa kernels_init(CpuIsa isa) {
+    CpuIsa best = cpu_best_isa(detect_cpu_features());
+    if (isa > best) isa = best;
+
+    kernels_build_table(&global_kernels, isa);
+    return isa;
+}
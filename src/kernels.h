@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "cpu_features.h"
+
+// ##################################################################
+//                      Kernel Dispatch Table
+// ##################################################################
+//
+// Inner loops of the pixel and audio paths. Callers do all clipping and
+// bounds work; kernels only see rectangles that are fully on screen and
+// non-empty (width > 0, height > 0).
+//
+// Every ISA file binds only the kernels it improves, on top of the table
+// built by the level below it, so the scalar versions are always present.
+
+// Fills a rectangle with a solid color
+typedef void fill_pixels_kernel(uint8_t* dest_row, int dest_pitch, int width, int height, uint32_t color);
+
+// Copies pixels (source_pitch is in pixels)
+typedef void copy_pixels_kernel(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                                int width, int height);
+
+// Alpha-blends premultiplied ARGB source pixels over the destination: s + d * (255 - a) / 255
+// alpha 0 leaves the destination untouched, otherwise the result is opaque
+typedef void blend_pixels_kernel(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                                 int width, int height);
+
+// Adds the color of premultiplied ARGB source pixels to the destination, saturating at 255
+// The destination alpha is kept
+typedef void add_pixels_kernel(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                               int width, int height);
+
+// Triangle rasterization works on square blocks of pixels (tile-aligned on the screen)
+#define RASTER_BLOCK_SIZE 8
+
+// Edge functions of a triangle over one block: edge k at pixel (x, y) of the block is
+// origin[k] + x * step_x[k] + y * step_y[k]. A pixel is inside when all three are >= 0.
+// Edges that do not cross the block are passed as all zeros (always inside).
+struct RasterEdges {
+    int32_t origin[3];
+    int32_t step_x[3];
+    int32_t step_y[3];
+};
+
+// Fills the pixels of a block (width, height <= RASTER_BLOCK_SIZE) that are inside all three edges
+typedef void fill_edges_kernel(uint8_t* dest_row, int dest_pitch, int width, int height,
+                               const RasterEdges* edges, uint32_t color);
+
+// Integrates particles for one step (SoA arrays, count may be any size):
+// vel_y += gravity * dt; pos += vel * dt; life -= dt
+// Same operation order as the player physics in game_update
+typedef void update_particles_kernel(float* pos_x, float* pos_y, float* vel_x, float* vel_y, float* life,
+                                     int count, float dt, float gravity);
+
+// Asset conversion (load time): one row of file pixels -> premultiplied ARGB.
+// Sources are raw bytes (file data has no alignment guarantees).
+
+// B, G, R, A bytes with straight alpha -> premultiplied ARGB
+// In place is allowed (dest == source exactly: every pixel stays 4 bytes); any other overlap is not
+typedef void premultiply_pixels_kernel(uint32_t* dest, const uint8_t* source, int count);
+
+// B, G, R bytes (24-bit) -> opaque ARGB
+// dest must not overlap source: each 4-byte output would overwrite source bytes not read yet
+typedef void expand_bgr_pixels_kernel(uint32_t* dest, const uint8_t* source, int count);
+
+// B, G, R, X bytes (32-bit, 4th byte ignored) -> opaque ARGB
+// Returns true if any 4th byte is nonzero (the caller decides whether it was alpha after all)
+// In place is allowed (dest == source exactly); any other overlap is not
+typedef bool expand_bgrx_pixels_kernel(uint32_t* dest, const uint8_t* source, int count);
+
+// Writes interleaved stereo int16 frames: test tone + mixed voices (normalized floats), saturated
+// phase is the tone oscillator phase in radians, kept in [0, 2*pi)
+typedef void write_sound_samples_kernel(int16_t* sample_out, const float* mix_left, const float* mix_right,
+                                        uint32_t sample_count, float* phase, float phase_step, float tone_volume);
+
+struct EngineKernels {
+    CpuIsa isa;                                     // Level the table was built for
+    fill_pixels_kernel* fill_pixels;
+    copy_pixels_kernel* copy_pixels;
+    blend_pixels_kernel* blend_pixels;
+    add_pixels_kernel* add_pixels;
+    premultiply_pixels_kernel* premultiply_pixels;
+    expand_bgr_pixels_kernel* expand_bgr_pixels;
+    expand_bgrx_pixels_kernel* expand_bgrx_pixels;
+    write_sound_samples_kernel* write_sound_samples;
+    update_particles_kernel* update_particles;
+    fill_edges_kernel* fill_edges;
+};
+
+// Active kernel table (scalar until kernels_init is called)
+extern EngineKernels global_kernels;
+
+// Binds the best kernels for the requested level. Levels above what the
+// machine supports are clamped down. Returns the level actually bound.
+CpuIsa kernels_init(CpuIsa isa);
+
+// Builds a table for a level without making it active (used to compare variants)
+void kernels_build_table(EngineKernels* table, CpuIsa isa);
+
+// Per-ISA binders (each one lives in its own translation unit compiled for that ISA)
+void kernels_bind_scalar(EngineKernels* table);
+void kernels_bind_sse2(EngineKernels* table);
+void kernels_bind_sse41(EngineKernels* table);
+void kernels_bind_avx2(EngineKernels* table);
+void kernels_bind_avx512(EngineKernels* table);
@@ -0,0 +1,305 @@
+#include "kernels.h"
+#include "kernels_internal.h"
+
+#if CPU_X86
+#include <immintrin.h>
+#include <math.h>   // Required for sinf (tails)
+
+// ##################################################################
+//                      AVX2 Kernels (8 pixels / 8 frames)
+// ##################################################################
+
+static void fill_pixels_avx2(uint8_t* dest_row, int dest_pitch, int width, int height, uint32_t color) {
+    __m256i color8 = _mm256_set1_epi32((int)color);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            _mm256_storeu_si256((__m256i*)(pixel + x), color8);
+        }
+        for (; x < width; ++x) {
+            pixel[x] = color;
+        }
+        dest_row += dest_pitch;
+    }
+}
+
+static void copy_pixels_avx2(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                             int width, int height) {
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            _mm256_storeu_si256((__m256i*)(dest_pixel + x), _mm256_loadu_si256((const __m256i*)(source_row + x)));
+        }
+        for (; x < width; ++x) {
+            dest_pixel[x] = source_row[x];
+        }
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void blend_pixels_avx2(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                              int width, int height) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha_bits = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i c255 = _mm256_set1_epi16(255);
+    const __m256i c128 = _mm256_set1_epi16(128);
+
+    // Copies each 16-bit alpha word to the 4 channels of its pixel (per 128-bit lane)
+    const __m256i alpha_shuffle = _mm256_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15,
+                                                   6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+
+        for (; x + 8 <= width; x += 8) {
+            __m256i src = _mm256_loadu_si256((const __m256i*)(source_row + x));
+
+            if (_mm256_testz_si256(src, alpha_bits)) continue;
+            if (_mm256_testc_si256(src, alpha_bits)) {
+                _mm256_storeu_si256((__m256i*)(dest_pixel + x), src);
+                continue;
+            }
+
+            __m256i dst = _mm256_loadu_si256((const __m256i*)(dest_pixel + x));
+
+            // unpack/pack work inside each 128-bit lane, so pixel order is preserved
+            __m256i src_lo = _mm256_unpacklo_epi8(src, zero);
+            __m256i src_hi = _mm256_unpackhi_epi8(src, zero);
+            __m256i dst_lo = _mm256_unpacklo_epi8(dst, zero);
+            __m256i dst_hi = _mm256_unpackhi_epi8(dst, zero);
+
+            __m256i inv_a_lo = _mm256_sub_epi16(c255, _mm256_shuffle_epi8(src_lo, alpha_shuffle));
+            __m256i inv_a_hi = _mm256_sub_epi16(c255, _mm256_shuffle_epi8(src_hi, alpha_shuffle));
+
+            // d * (255 - a) / 255, rounded, then a saturating add of the premultiplied source
+            __m256i t_lo = _mm256_add_epi16(_mm256_mullo_epi16(dst_lo, inv_a_lo), c128);
+            __m256i t_hi = _mm256_add_epi16(_mm256_mullo_epi16(dst_hi, inv_a_hi), c128);
+            t_lo = _mm256_srli_epi16(_mm256_add_epi16(t_lo, _mm256_srli_epi16(t_lo, 8)), 8);
+            t_hi = _mm256_srli_epi16(_mm256_add_epi16(t_hi, _mm256_srli_epi16(t_hi, 8)), 8);
+
+            __m256i blended = _mm256_or_si256(_mm256_adds_epu8(src, _mm256_packus_epi16(t_lo, t_hi)), alpha_bits);
+
+            // Keep the destination where alpha == 0
+            __m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(src, alpha_bits), zero);
+            _mm256_storeu_si256((__m256i*)(dest_pixel + x), _mm256_blendv_epi8(blended, dst, transparent));
+        }
+        for (; x < width; ++x) {
+            dest_pixel[x] = blend_pixel(source_row[x], dest_pixel[x]);
+        }
+
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void add_pixels_avx2(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                            int width, int height) {
+    const __m256i color_bits = _mm256_set1_epi32(0x00FFFFFF);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+
+        for (; x + 8 <= width; x += 8) {
+            __m256i src = _mm256_loadu_si256((const __m256i*)(source_row + x));
+            if (_mm256_testz_si256(src, color_bits)) continue;
+
+            __m256i addend = _mm256_and_si256(src, color_bits);
+            __m256i dst = _mm256_loadu_si256((const __m256i*)(dest_pixel + x));
+            _mm256_storeu_si256((__m256i*)(dest_pixel + x), _mm256_adds_epu8(dst, addend));
+        }
+        for (; x < width; ++x) {
+            dest_pixel[x] = add_pixel(source_row[x], dest_pixel[x]);
+        }
+
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void premultiply_pixels_avx2(uint32_t* dest, const uint8_t* source, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha_bits = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i c128 = _mm256_set1_epi16(128);
+    const __m256i alpha_shuffle = _mm256_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15,
+                                                   6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*)(source + 4 * i));
+        __m256i lo = _mm256_unpacklo_epi8(pixels, zero);
+        __m256i hi = _mm256_unpackhi_epi8(pixels, zero);
+
+        __m256i t_lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, _mm256_shuffle_epi8(lo, alpha_shuffle)), c128);
+        __m256i t_hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, _mm256_shuffle_epi8(hi, alpha_shuffle)), c128);
+        t_lo = _mm256_srli_epi16(_mm256_add_epi16(t_lo, _mm256_srli_epi16(t_lo, 8)), 8);
+        t_hi = _mm256_srli_epi16(_mm256_add_epi16(t_hi, _mm256_srli_epi16(t_hi, 8)), 8);
+
+        // Colors from the math, alpha straight from the source
+        __m256i color = _mm256_andnot_si256(alpha_bits, _mm256_packus_epi16(t_lo, t_hi));
+        _mm256_storeu_si256((__m256i*)(dest + i), _mm256_or_si256(color, _mm256_and_si256(pixels, alpha_bits)));
+    }
+    for (; i < count; ++i) {
+        dest[i] = premultiply_pixel(source + 4 * i);
+    }
+}
+
+static bool expand_bgrx_pixels_avx2(uint32_t* dest, const uint8_t* source, int count) {
+    const __m256i alpha_bits = _mm256_set1_epi32((int)0xFF000000);
+    __m256i fourth_bytes = _mm256_setzero_si256();
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*)(source + 4 * i));
+        fourth_bytes = _mm256_or_si256(fourth_bytes, pixels);
+        _mm256_storeu_si256((__m256i*)(dest + i), _mm256_or_si256(pixels, alpha_bits));
+    }
+
+    bool any = !_mm256_testz_si256(fourth_bytes, alpha_bits);
+    for (; i < count; ++i) {
+        const uint8_t* bgrx = source + 4 * i;
+        any |= bgrx[3] != 0;
+        dest[i] = 0xFF000000 | ((uint32_t)bgrx[2] << 16) | ((uint32_t)bgrx[1] << 8) | bgrx[0];
+    }
+    return any;
+}
+
+// 8-wide version of sin_ps_sse2 (same reduction and polynomial)
+static inline __m256 sin_ps_avx2(__m256 x) {
+    const __m256 two_pi = _mm256_set1_ps(KERNELS_TWO_PI);
+    const __m256 inv_two_pi = _mm256_set1_ps(1.0f / KERNELS_TWO_PI);
+    const __m256 pi = _mm256_set1_ps(3.14159265358979323846f);
+    const __m256 half_pi = _mm256_set1_ps(1.57079632679489661923f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 k = _mm256_round_ps(_mm256_mul_ps(x, inv_two_pi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm256_sub_ps(x, _mm256_mul_ps(k, two_pi));
+
+    __m256 above = _mm256_cmp_ps(x, half_pi, _CMP_GT_OQ);
+    __m256 below = _mm256_cmp_ps(x, _mm256_sub_ps(zero, half_pi), _CMP_LT_OQ);
+    x = _mm256_blendv_ps(x, _mm256_sub_ps(pi, x), above);
+    x = _mm256_blendv_ps(x, _mm256_sub_ps(_mm256_sub_ps(zero, pi), x), below);
+
+    __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 p = _mm256_set1_ps(-2.5052108385e-8f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(2.7557319224e-6f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(-1.9841269841e-4f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(8.3333333333e-3f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(-1.6666666667e-1f));
+    return _mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(x, x2), p));
+}
+
+static void write_sound_samples_avx2(int16_t* sample_out, const float* mix_left, const float* mix_right,
+                                     uint32_t sample_count, float* phase, float phase_step, float tone_volume) {
+    const __m256 lane_offsets = _mm256_mul_ps(_mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_ps(phase_step));
+    const __m256 volume = _mm256_set1_ps(tone_volume);
+    const __m256 scale = _mm256_set1_ps(32767.0f);
+    const __m256 max_sample = _mm256_set1_ps(32767.0f);
+    const __m256 min_sample = _mm256_set1_ps(-32768.0f);
+
+    float t = *phase;
+    uint32_t i = 0;
+
+    for (; i + 8 <= sample_count; i += 8) {
+        __m256 sine = _mm256_mul_ps(sin_ps_avx2(_mm256_add_ps(_mm256_set1_ps(t), lane_offsets)), volume);
+
+        __m256 left = _mm256_add_ps(sine, _mm256_mul_ps(_mm256_loadu_ps(mix_left + i), scale));
+        __m256 right = _mm256_add_ps(sine, _mm256_mul_ps(_mm256_loadu_ps(mix_right + i), scale));
+        left = _mm256_min_ps(_mm256_max_ps(left, min_sample), max_sample);
+        right = _mm256_min_ps(_mm256_max_ps(right, min_sample), max_sample);
+
+        // Per lane: L0-3 R0-3 | L4-7 R4-7 -> L0 R0 .. L3 R3 | L4 R4 .. L7 R7
+        __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(left), _mm256_cvttps_epi32(right));
+        __m256i interleaved = _mm256_unpacklo_epi16(packed, _mm256_srli_si256(packed, 8));
+        _mm256_storeu_si256((__m256i*)(sample_out + 2 * i), interleaved);
+
+        t += 8.0f * phase_step;
+        if (t > KERNELS_TWO_PI) t -= KERNELS_TWO_PI;
+    }
+
+    for (; i < sample_count; ++i) {
+        float sine_value = sinf(t) * tone_volume;
+        sample_out[2 * i] = saturate_sample(sine_value + mix_left[i] * 32767.0f);
+        sample_out[2 * i + 1] = saturate_sample(sine_value + mix_right[i] * 32767.0f);
+
+        t += phase_step;
+        if (t > KERNELS_TWO_PI) t -= KERNELS_TWO_PI;
+    }
+
+    *phase = t;
+}
+
+// No FMA: mul + add keeps the results identical to the scalar and SSE2 versions
+static void update_particles_avx2(float* pos_x, float* pos_y, float* vel_x, float* vel_y, float* life,
+                                  int count, float dt, float gravity) {
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    const __m256 gravity_step = _mm256_set1_ps(gravity * dt);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(vel_y + i), gravity_step);
+        __m256 vx = _mm256_loadu_ps(vel_x + i);
+        _mm256_storeu_ps(vel_y + i, vy);
+        _mm256_storeu_ps(pos_x + i, _mm256_add_ps(_mm256_loadu_ps(pos_x + i), _mm256_mul_ps(vx, dt8)));
+        _mm256_storeu_ps(pos_y + i, _mm256_add_ps(_mm256_loadu_ps(pos_y + i), _mm256_mul_ps(vy, dt8)));
+        _mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), dt8));
+    }
+    for (; i < count; ++i) {
+        update_particle(pos_x + i, pos_y + i, vel_x + i, vel_y + i, life + i, dt, gravity);
+    }
+}
+
+// One block row (8 pixels) per step, written with a masked store: no scalar tail
+static void fill_edges_avx2(uint8_t* dest_row, int dest_pitch, int width, int height,
+                            const RasterEdges* edges, uint32_t color) {
+    const __m256i color8 = _mm256_set1_epi32((int)color);
+    const __m256i lane_index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i columns = _mm256_cmpgt_epi32(_mm256_set1_epi32(width), lane_index);
+
+    __m256i e[3];
+    __m256i step_y[3];
+    for (int k = 0; k < 3; ++k) {
+        e[k] = _mm256_add_epi32(_mm256_set1_epi32(edges->origin[k]),
+                                _mm256_mullo_epi32(lane_index, _mm256_set1_epi32(edges->step_x[k])));
+        step_y[k] = _mm256_set1_epi32(edges->step_y[k]);
+    }
+
+    for (int y = 0; y < height; ++y) {
+        __m256i outside = _mm256_srai_epi32(_mm256_or_si256(_mm256_or_si256(e[0], e[1]), e[2]), 31);
+        __m256i inside = _mm256_andnot_si256(outside, columns);
+        if (!_mm256_testz_si256(inside, inside)) {
+            _mm256_maskstore_epi32((int*)dest_row, inside, color8);
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            e[k] = _mm256_add_epi32(e[k], step_y[k]);
+        }
+        dest_row += dest_pitch;
+    }
+}
+
+void kernels_bind_avx2(EngineKernels* table) {
+    table->isa = CPU_ISA_AVX2;
+    table->fill_pixels = fill_pixels_avx2;
+    table->copy_pixels = copy_pixels_avx2;
+    table->blend_pixels = blend_pixels_avx2;
+    table->add_pixels = add_pixels_avx2;
+    table->premultiply_pixels = premultiply_pixels_avx2;
+    table->expand_bgrx_pixels = expand_bgrx_pixels_avx2;
+    table->write_sound_samples = write_sound_samples_avx2;
+    table->update_particles = update_particles_avx2;
+    table->fill_edges = fill_edges_avx2;
+}
+
+#else
+
+void kernels_bind_avx2(EngineKernels* table) {
+    (void)table;
+}
+
+#endif // CPU_X86
@@ -0,0 +1,184 @@
+#include "kernels.h"
+#include "kernels_internal.h"
+
+#if CPU_X86
+#include <immintrin.h>
+
+// ##################################################################
+//                  AVX-512 F+BW Kernels (16 pixels)
+// ##################################################################
+//
+// Row tails use masked loads/stores instead of a scalar loop.
+// Sound and the particle update keep the AVX2 versions (memory bound, or too short to gain from 16 lanes).
+
+// Mask selecting the first `count` (< 16) 32-bit lanes
+static inline __mmask16 tail_mask(int count) {
+    return (__mmask16)((1u << count) - 1);
+}
+
+static void fill_pixels_avx512(uint8_t* dest_row, int dest_pitch, int width, int height, uint32_t color) {
+    __m512i color16 = _mm512_set1_epi32((int)color);
+    __mmask16 last = tail_mask(width & 15);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            _mm512_storeu_si512(pixel + x, color16);
+        }
+        if (last) _mm512_mask_storeu_epi32(pixel + x, last, color16);
+        dest_row += dest_pitch;
+    }
+}
+
+static void copy_pixels_avx512(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                               int width, int height) {
+    __mmask16 last = tail_mask(width & 15);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            _mm512_storeu_si512(dest_pixel + x, _mm512_loadu_si512(source_row + x));
+        }
+        if (last) _mm512_mask_storeu_epi32(dest_pixel + x, last, _mm512_maskz_loadu_epi32(last, source_row + x));
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+// Blends up to 16 pixels; lanes outside `lanes` are neither read nor written
+static inline void blend16_avx512(uint32_t* dest, const uint32_t* source, __mmask16 lanes) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i alpha_bits = _mm512_set1_epi32((int)0xFF000000);
+    const __m512i c255 = _mm512_set1_epi16(255);
+    const __m512i c128 = _mm512_set1_epi16(128);
+    const __m512i alpha_shuffle = _mm512_set4_epi32(0x0F0E0F0E, 0x0F0E0F0E, 0x07060706, 0x07060706);
+
+    __m512i src = _mm512_maskz_loadu_epi32(lanes, source);
+
+    // Only pixels with alpha != 0 are written; fully opaque ones are copied
+    __mmask16 visible = _mm512_mask_test_epi32_mask(lanes, src, alpha_bits);
+    if (!visible) return;
+    __mmask16 opaque = _mm512_mask_cmpeq_epi32_mask(visible, _mm512_and_si512(src, alpha_bits), alpha_bits);
+    if (opaque == visible) {
+        _mm512_mask_storeu_epi32(dest, visible, src);
+        return;
+    }
+
+    __m512i dst = _mm512_maskz_loadu_epi32(lanes, dest);
+
+    __m512i src_lo = _mm512_unpacklo_epi8(src, zero);
+    __m512i src_hi = _mm512_unpackhi_epi8(src, zero);
+    __m512i dst_lo = _mm512_unpacklo_epi8(dst, zero);
+    __m512i dst_hi = _mm512_unpackhi_epi8(dst, zero);
+
+    __m512i inv_a_lo = _mm512_sub_epi16(c255, _mm512_shuffle_epi8(src_lo, alpha_shuffle));
+    __m512i inv_a_hi = _mm512_sub_epi16(c255, _mm512_shuffle_epi8(src_hi, alpha_shuffle));
+
+    // d * (255 - a) / 255, rounded, then a saturating add of the premultiplied source
+    __m512i t_lo = _mm512_add_epi16(_mm512_mullo_epi16(dst_lo, inv_a_lo), c128);
+    __m512i t_hi = _mm512_add_epi16(_mm512_mullo_epi16(dst_hi, inv_a_hi), c128);
+    t_lo = _mm512_srli_epi16(_mm512_add_epi16(t_lo, _mm512_srli_epi16(t_lo, 8)), 8);
+    t_hi = _mm512_srli_epi16(_mm512_add_epi16(t_hi, _mm512_srli_epi16(t_hi, 8)), 8);
+
+    __m512i blended = _mm512_or_si512(_mm512_adds_epu8(src, _mm512_packus_epi16(t_lo, t_hi)), alpha_bits);
+    _mm512_mask_storeu_epi32(dest, visible, blended);
+}
+
+static void blend_pixels_avx512(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                                int width, int height) {
+    __mmask16 last = tail_mask(width & 15);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            blend16_avx512(dest_pixel + x, source_row + x, 0xFFFF);
+        }
+        if (last) blend16_avx512(dest_pixel + x, source_row + x, last);
+
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+// Adds up to 16 pixels; lanes outside `lanes` are neither read nor written
+static inline void add16_avx512(uint32_t* dest, const uint32_t* source, __mmask16 lanes) {
+    const __m512i color_bits = _mm512_set1_epi32(0x00FFFFFF);
+
+    __m512i src = _mm512_maskz_loadu_epi32(lanes, source);
+    __mmask16 visible = _mm512_mask_test_epi32_mask(lanes, src, color_bits);
+    if (!visible) return;
+
+    __m512i dst = _mm512_maskz_loadu_epi32(visible, dest);
+    _mm512_mask_storeu_epi32(dest, visible, _mm512_adds_epu8(dst, _mm512_and_si512(src, color_bits)));
+}
+
+// Particle sprites are a few pixels wide, so the masked tail is the common case here
+static void add_pixels_avx512(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                              int width, int height) {
+    __mmask16 last = tail_mask(width & 15);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            add16_avx512(dest_pixel + x, source_row + x, 0xFFFF);
+        }
+        if (last) add16_avx512(dest_pixel + x, source_row + x, last);
+
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+// Two block rows (16 pixels) per step. The second row is stored through a pointer 8 pixels
+// before it with only the upper lanes enabled (masked-off lanes never touch memory).
+static void fill_edges_avx512(uint8_t* dest_row, int dest_pitch, int width, int height,
+                              const RasterEdges* edges, uint32_t color) {
+    const __m512i color16 = _mm512_set1_epi32((int)color);
+    const __m512i lane_index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512i lane_row = _mm512_setr_epi32(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+    const __mmask16 columns = (__mmask16)(((1u << width) - 1) * 0x0101);
+
+    __m512i e[3];
+    __m512i step_y2[3];
+    for (int k = 0; k < 3; ++k) {
+        e[k] = _mm512_add_epi32(_mm512_set1_epi32(edges->origin[k]),
+                                _mm512_add_epi32(_mm512_mullo_epi32(lane_index, _mm512_set1_epi32(edges->step_x[k])),
+                                                 _mm512_mullo_epi32(lane_row, _mm512_set1_epi32(edges->step_y[k]))));
+        step_y2[k] = _mm512_set1_epi32(2 * edges->step_y[k]);
+    }
+
+    for (int y = 0; y < height; y += 2) {
+        __m512i any = _mm512_or_epi32(_mm512_or_epi32(e[0], e[1]), e[2]);
+        __mmask16 inside = _mm512_cmpge_epi32_mask(any, _mm512_setzero_si512()) & columns;
+        if (y + 1 == height) inside &= 0x00FF;
+
+        _mm512_mask_storeu_epi32(dest_row, inside & 0x00FF, color16);
+        _mm512_mask_storeu_epi32((uint32_t*)(dest_row + dest_pitch) - 8, inside & 0xFF00, color16);
+
+        for (int k = 0; k < 3; ++k) {
+            e[k] = _mm512_add_epi32(e[k], step_y2[k]);
+        }
+        dest_row += 2 * dest_pitch;
+    }
+}
+
+void kernels_bind_avx512(EngineKernels* table) {
+    table->isa = CPU_ISA_AVX512;
+    table->fill_pixels = fill_pixels_avx512;
+    table->copy_pixels = copy_pixels_avx512;
+    table->blend_pixels = blend_pixels_avx512;
+    table->add_pixels = add_pixels_avx512;
+    table->fill_edges = fill_edges_avx512;
+}
+
+#else
+
+void kernels_bind_avx512(EngineKernels* table) {
+    (void)table;
+}
+
+#endif // CPU_X86
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdint.h>
+
+// ##################################################################
+//                  Shared Scalar Helpers
+// ##################################################################
+//
+// Used by the scalar kernels and by the tails of the SIMD kernels (and by
+// the few per-pixel loops outside the kernels that must match them).
+// Everything here is static so each ISA translation unit gets its own copy
+// compiled with its own flags (no cross-ISA inline merging by the linker).
+
+// round(c * f / 255) for 8-bit c and f. Every SIMD variant uses the same
+// integer formula so all ISAs produce bit-identical frames.
+static inline uint32_t scale_channel(uint32_t c, uint32_t f) {
+    uint32_t t = c * f + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+// Saturating 8-bit add
+static inline uint32_t add_channel(uint32_t a, uint32_t b) {
+    uint32_t sum = a + b;
+    return sum > 255 ? 255 : sum;
+}
+
+// Blends one premultiplied ARGB pixel: s + d * (255 - a) / 255 per channel, saturated.
+// alpha 0 keeps the destination, otherwise the result is opaque
+static inline uint32_t blend_pixel(uint32_t src_color, uint32_t dst_color) {
+    uint32_t alpha = src_color >> 24;
+    if (alpha == 255) return src_color;
+    if (alpha == 0) return dst_color;
+
+    uint32_t inv_alpha = 255 - alpha;
+    uint32_t r = add_channel((src_color >> 16) & 0xFF, scale_channel((dst_color >> 16) & 0xFF, inv_alpha));
+    uint32_t g = add_channel((src_color >> 8) & 0xFF, scale_channel((dst_color >> 8) & 0xFF, inv_alpha));
+    uint32_t b = add_channel(src_color & 0xFF, scale_channel(dst_color & 0xFF, inv_alpha));
+    return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+// Adds the (premultiplied) color of one pixel to the destination, saturated, destination alpha kept
+static inline uint32_t add_pixel(uint32_t src_color, uint32_t dst_color) {
+    uint32_t r = add_channel((dst_color >> 16) & 0xFF, (src_color >> 16) & 0xFF);
+    uint32_t g = add_channel((dst_color >> 8) & 0xFF, (src_color >> 8) & 0xFF);
+    uint32_t b = add_channel(dst_color & 0xFF, src_color & 0xFF);
+    return (dst_color & 0xFF000000) | (r << 16) | (g << 8) | b;
+}
+
+// Straight -> premultiplied alpha for one pixel stored as B, G, R, A bytes
+static inline uint32_t premultiply_pixel(const uint8_t* bgra) {
+    uint32_t alpha = bgra[3];
+    return (alpha << 24) | (scale_channel(bgra[2], alpha) << 16) |
+           (scale_channel(bgra[1], alpha) << 8) | scale_channel(bgra[0], alpha);
+}
+
+// One particle step (also used for the tails of the SIMD versions)
+static inline void update_particle(float* pos_x, float* pos_y, float* vel_x, float* vel_y, float* life,
+                                   float dt, float gravity) {
+    *vel_y += gravity * dt;
+    *pos_x += *vel_x * dt;
+    *pos_y += *vel_y * dt;
+    *life -= dt;
+}
+
+// Saturates a mixed sample to the int16 range (truncating like a plain cast)
+static inline int16_t saturate_sample(float value) {
+    if (value > 32767.0f) value = 32767.0f;
+    if (value < -32768.0f) value = -32768.0f;
+    return (int16_t)value;
+}
+
+#define KERNELS_TWO_PI 6.28318530717958647692f
@@ -0,0 +1,340 @@
+#include "kernels.h"
+#include "kernels_internal.h"
+
+#if CPU_X86
+#include <emmintrin.h>
+#include <math.h>   // Required for sinf (tails)
+
+// ##################################################################
+//                      SSE2 Kernels (4 pixels / 4 frames)
+// ##################################################################
+
+static void fill_pixels_sse2(uint8_t* dest_row, int dest_pitch, int width, int height, uint32_t color) {
+    __m128i color4 = _mm_set1_epi32((int)color);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            _mm_storeu_si128((__m128i*)(pixel + x), color4);
+        }
+        for (; x < width; ++x) {
+            pixel[x] = color;
+        }
+        dest_row += dest_pitch;
+    }
+}
+
+static void copy_pixels_sse2(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                             int width, int height) {
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            _mm_storeu_si128((__m128i*)(dest_pixel + x), _mm_loadu_si128((const __m128i*)(source_row + x)));
+        }
+        for (; x < width; ++x) {
+            dest_pixel[x] = source_row[x];
+        }
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+// round(c * f / 255) on 16-bit lanes, same rounding as scale_channel
+static inline __m128i scale_epi16_sse2(__m128i c, __m128i f) {
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, f), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// Broadcasts the alpha word (word 3 of each pixel) of 2 widened pixels to their 4 channels
+static inline __m128i broadcast_alpha_sse2(__m128i pixels16) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels16, 0xFF), 0xFF);
+}
+
+// Blends 4 premultiplied pixels: s + d * (255 - a) / 255 (alpha 0 handled by the caller)
+static inline __m128i blend4_sse2(__m128i src, __m128i dst) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+
+    // Widen to 16 bits: 2 pixels per register
+    __m128i inv_a_lo = _mm_sub_epi16(c255, broadcast_alpha_sse2(_mm_unpacklo_epi8(src, zero)));
+    __m128i inv_a_hi = _mm_sub_epi16(c255, broadcast_alpha_sse2(_mm_unpackhi_epi8(src, zero)));
+    __m128i dst_lo = scale_epi16_sse2(_mm_unpacklo_epi8(dst, zero), inv_a_lo);
+    __m128i dst_hi = scale_epi16_sse2(_mm_unpackhi_epi8(dst, zero), inv_a_hi);
+
+    // Saturating add, like add_channel
+    __m128i blended = _mm_adds_epu8(src, _mm_packus_epi16(dst_lo, dst_hi));
+    return _mm_or_si128(blended, _mm_set1_epi32((int)0xFF000000));
+}
+
+static void blend_pixels_sse2(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                              int width, int height) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_max = _mm_set1_epi32(255);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+
+        for (; x + 4 <= width; x += 4) {
+            __m128i src = _mm_loadu_si128((const __m128i*)(source_row + x));
+            __m128i alpha = _mm_srli_epi32(src, 24);
+
+            // Fully transparent or fully opaque groups skip the math
+            __m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+            if (_mm_movemask_epi8(transparent) == 0xFFFF) continue;
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alpha_max)) == 0xFFFF) {
+                _mm_storeu_si128((__m128i*)(dest_pixel + x), src);
+                continue;
+            }
+
+            __m128i dst = _mm_loadu_si128((const __m128i*)(dest_pixel + x));
+            __m128i blended = blend4_sse2(src, dst);
+
+            // Keep the destination where alpha == 0
+            __m128i result = _mm_or_si128(_mm_and_si128(transparent, dst), _mm_andnot_si128(transparent, blended));
+            _mm_storeu_si128((__m128i*)(dest_pixel + x), result);
+        }
+        for (; x < width; ++x) {
+            dest_pixel[x] = blend_pixel(source_row[x], dest_pixel[x]);
+        }
+
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void add_pixels_sse2(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                            int width, int height) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i color_bits = _mm_set1_epi32(0x00FFFFFF);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+
+        for (; x + 4 <= width; x += 4) {
+            // Alpha byte of the addend is cleared so the destination alpha is kept
+            __m128i addend = _mm_and_si128(_mm_loadu_si128((const __m128i*)(source_row + x)), color_bits);
+
+            // Black groups add nothing
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(addend, zero)) == 0xFFFF) continue;
+
+            __m128i dst = _mm_loadu_si128((const __m128i*)(dest_pixel + x));
+            _mm_storeu_si128((__m128i*)(dest_pixel + x), _mm_adds_epu8(dst, addend));
+        }
+        for (; x < width; ++x) {
+            dest_pixel[x] = add_pixel(source_row[x], dest_pixel[x]);
+        }
+
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+static void premultiply_pixels_sse2(uint32_t* dest, const uint8_t* source, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_bits = _mm_set1_epi32((int)0xFF000000);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(source + 4 * i));
+        __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+        __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+        lo = scale_epi16_sse2(lo, broadcast_alpha_sse2(lo));
+        hi = scale_epi16_sse2(hi, broadcast_alpha_sse2(hi));
+
+        // The alpha channel came out as round(a * a / 255): put the original back
+        __m128i color = _mm_andnot_si128(alpha_bits, _mm_packus_epi16(lo, hi));
+        _mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(color, _mm_and_si128(pixels, alpha_bits)));
+    }
+    for (; i < count; ++i) {
+        dest[i] = premultiply_pixel(source + 4 * i);
+    }
+}
+
+static bool expand_bgrx_pixels_sse2(uint32_t* dest, const uint8_t* source, int count) {
+    const __m128i alpha_bits = _mm_set1_epi32((int)0xFF000000);
+    __m128i fourth_bytes = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(source + 4 * i));
+        fourth_bytes = _mm_or_si128(fourth_bytes, pixels);
+        _mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(pixels, alpha_bits));
+    }
+
+    // Only the alpha bytes count: nonzero if any of them was set
+    fourth_bytes = _mm_and_si128(fourth_bytes, alpha_bits);
+    bool any = _mm_movemask_epi8(_mm_cmpeq_epi8(fourth_bytes, _mm_setzero_si128())) != 0xFFFF;
+    for (; i < count; ++i) {
+        const uint8_t* bgrx = source + 4 * i;
+        any |= bgrx[3] != 0;
+        dest[i] = 0xFF000000 | ((uint32_t)bgrx[2] << 16) | ((uint32_t)bgrx[1] << 8) | bgrx[0];
+    }
+    return any;
+}
+
+// sin(x) for x in roughly [-pi, 3pi]: range reduction + odd Taylor polynomial up to x^11
+// Max error ~1e-7, far below one int16 step at the tone volume
+static inline __m128 sin_ps_sse2(__m128 x) {
+    const __m128 two_pi = _mm_set1_ps(KERNELS_TWO_PI);
+    const __m128 inv_two_pi = _mm_set1_ps(1.0f / KERNELS_TWO_PI);
+    const __m128 pi = _mm_set1_ps(3.14159265358979323846f);
+    const __m128 half_pi = _mm_set1_ps(1.57079632679489661923f);
+
+    // x -> [-pi, pi]
+    __m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, inv_two_pi)));
+    x = _mm_sub_ps(x, _mm_mul_ps(k, two_pi));
+
+    // Fold into [-pi/2, pi/2] using sin(pi - x) = sin(x)
+    __m128 above = _mm_cmpgt_ps(x, half_pi);
+    __m128 below = _mm_cmplt_ps(x, _mm_sub_ps(_mm_setzero_ps(), half_pi));
+    __m128 folded_above = _mm_sub_ps(pi, x);
+    __m128 folded_below = _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), pi), x);
+    x = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(above, below), x),
+                  _mm_or_ps(_mm_and_ps(above, folded_above), _mm_and_ps(below, folded_below)));
+
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_set1_ps(-2.5052108385e-8f);                          // -1/11!
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.7557319224e-6f));   //  1/9!
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.9841269841e-4f));  // -1/7!
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.3333333333e-3f));   //  1/5!
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.6666666667e-1f));  // -1/3!
+    return _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(x, x2), p));
+}
+
+static void write_sound_samples_sse2(int16_t* sample_out, const float* mix_left, const float* mix_right,
+                                     uint32_t sample_count, float* phase, float phase_step, float tone_volume) {
+    const __m128 lane_offsets = _mm_setr_ps(0.0f, phase_step, 2.0f * phase_step, 3.0f * phase_step);
+    const __m128 volume = _mm_set1_ps(tone_volume);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    const __m128 max_sample = _mm_set1_ps(32767.0f);
+    const __m128 min_sample = _mm_set1_ps(-32768.0f);
+
+    float t = *phase;
+    uint32_t i = 0;
+
+    for (; i + 4 <= sample_count; i += 4) {
+        __m128 sine = _mm_mul_ps(sin_ps_sse2(_mm_add_ps(_mm_set1_ps(t), lane_offsets)), volume);
+
+        __m128 left = _mm_add_ps(sine, _mm_mul_ps(_mm_loadu_ps(mix_left + i), scale));
+        __m128 right = _mm_add_ps(sine, _mm_mul_ps(_mm_loadu_ps(mix_right + i), scale));
+        left = _mm_min_ps(_mm_max_ps(left, min_sample), max_sample);
+        right = _mm_min_ps(_mm_max_ps(right, min_sample), max_sample);
+
+        // L0 L1 L2 L3 R0 R1 R2 R3 -> L0 R0 L1 R1 L2 R2 L3 R3
+        __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(left), _mm_cvttps_epi32(right));
+        __m128i interleaved = _mm_unpacklo_epi16(packed, _mm_srli_si128(packed, 8));
+        _mm_storeu_si128((__m128i*)(sample_out + 2 * i), interleaved);
+
+        t += 4.0f * phase_step;
+        if (t > KERNELS_TWO_PI) t -= KERNELS_TWO_PI;
+    }
+
+    for (; i < sample_count; ++i) {
+        float sine_value = sinf(t) * tone_volume;
+        sample_out[2 * i] = saturate_sample(sine_value + mix_left[i] * 32767.0f);
+        sample_out[2 * i + 1] = saturate_sample(sine_value + mix_right[i] * 32767.0f);
+
+        t += phase_step;
+        if (t > KERNELS_TWO_PI) t -= KERNELS_TWO_PI;
+    }
+
+    *phase = t;
+}
+
+static void update_particles_sse2(float* pos_x, float* pos_y, float* vel_x, float* vel_y, float* life,
+                                  int count, float dt, float gravity) {
+    const __m128 dt4 = _mm_set1_ps(dt);
+    const __m128 gravity_step = _mm_set1_ps(gravity * dt);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(vel_y + i), gravity_step);
+        __m128 vx = _mm_loadu_ps(vel_x + i);
+        _mm_storeu_ps(vel_y + i, vy);
+        _mm_storeu_ps(pos_x + i, _mm_add_ps(_mm_loadu_ps(pos_x + i), _mm_mul_ps(vx, dt4)));
+        _mm_storeu_ps(pos_y + i, _mm_add_ps(_mm_loadu_ps(pos_y + i), _mm_mul_ps(vy, dt4)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt4));
+    }
+    for (; i < count; ++i) {
+        update_particle(pos_x + i, pos_y + i, vel_x + i, vel_y + i, life + i, dt, gravity);
+    }
+}
+
+// 4 pixels per step; a partial group is blended with the coverage mask, the row tail is scalar
+static void fill_edges_sse2(uint8_t* dest_row, int dest_pitch, int width, int height,
+                            const RasterEdges* edges, uint32_t color) {
+    const __m128i color4 = _mm_set1_epi32((int)color);
+    __m128i e_row[3];
+    __m128i step_x4[3];
+    __m128i step_y[3];
+    for (int k = 0; k < 3; ++k) {
+        int32_t s = edges->step_x[k];
+        e_row[k] = _mm_add_epi32(_mm_set1_epi32(edges->origin[k]), _mm_setr_epi32(0, s, 2 * s, 3 * s));
+        step_x4[k] = _mm_set1_epi32(4 * s);
+        step_y[k] = _mm_set1_epi32(edges->step_y[k]);
+    }
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* pixel = (uint32_t*)dest_row;
+        __m128i e0 = e_row[0];
+        __m128i e1 = e_row[1];
+        __m128i e2 = e_row[2];
+
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            // All ones in the lanes where some edge is negative
+            __m128i outside = _mm_srai_epi32(_mm_or_si128(_mm_or_si128(e0, e1), e2), 31);
+            int outside_bits = _mm_movemask_epi8(outside);
+
+            if (outside_bits == 0) {
+                _mm_storeu_si128((__m128i*)(pixel + x), color4);
+            } else if (outside_bits != 0xFFFF) {
+                __m128i dest = _mm_loadu_si128((__m128i*)(pixel + x));
+                __m128i result = _mm_or_si128(_mm_and_si128(outside, dest), _mm_andnot_si128(outside, color4));
+                _mm_storeu_si128((__m128i*)(pixel + x), result);
+            }
+
+            e0 = _mm_add_epi32(e0, step_x4[0]);
+            e1 = _mm_add_epi32(e1, step_x4[1]);
+            e2 = _mm_add_epi32(e2, step_x4[2]);
+        }
+
+        if (x < width) {
+            int32_t lanes[4];
+            _mm_storeu_si128((__m128i*)lanes, _mm_or_si128(_mm_or_si128(e0, e1), e2));
+            for (int i = 0; x + i < width; ++i) {
+                if (lanes[i] >= 0) pixel[x + i] = color;
+            }
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            e_row[k] = _mm_add_epi32(e_row[k], step_y[k]);
+        }
+        dest_row += dest_pitch;
+    }
+}
+
+void kernels_bind_sse2(EngineKernels* table) {
+    table->isa = CPU_ISA_SSE2;
+    table->fill_pixels = fill_pixels_sse2;
+    table->copy_pixels = copy_pixels_sse2;
+    table->blend_pixels = blend_pixels_sse2;
+    table->add_pixels = add_pixels_sse2;
+    table->premultiply_pixels = premultiply_pixels_sse2;
+    table->expand_bgrx_pixels = expand_bgrx_pixels_sse2;
+    table->write_sound_samples = write_sound_samples_sse2;
+    table->update_particles = update_particles_sse2;
+    table->fill_edges = fill_edges_sse2;
+}
+
+#else
+
+void kernels_bind_sse2(EngineKernels* table) {
+    (void)table; // No SSE2 on this architecture: keep the scalar kernels
+}
+
+#endif // CPU_X86
@@ -0,0 +1,97 @@
+#include "kernels.h"
+#include "kernels_internal.h"
+
+#if CPU_X86
+#include <smmintrin.h>
+
+// ##################################################################
+//                      SSE4.1 Kernels
+// ##################################################################
+//
+// Only the alpha blend (zero-extend, byte shuffle, blendv, ptest) and the
+// 24-bit expand (byte shuffle) benefit. The rest keeps the SSE2 versions.
+
+static void blend_pixels_sse41(uint8_t* dest_row, int dest_pitch, const uint32_t* source_row, int source_pitch,
+                               int width, int height) {
+    const __m128i alpha_bits = _mm_set1_epi32((int)0xFF000000);
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i c128 = _mm_set1_epi16(128);
+
+    // Byte shuffle that copies each 16-bit alpha word (word 3 of each pixel) to all 4 channels
+    const __m128i alpha_shuffle = _mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t* dest_pixel = (uint32_t*)dest_row;
+        int x = 0;
+
+        for (; x + 4 <= width; x += 4) {
+            __m128i src = _mm_loadu_si128((const __m128i*)(source_row + x));
+
+            // All alpha bytes zero -> nothing to do; all 0xFF -> plain copy
+            if (_mm_testz_si128(src, alpha_bits)) continue;
+            if (_mm_testc_si128(src, alpha_bits)) {
+                _mm_storeu_si128((__m128i*)(dest_pixel + x), src);
+                continue;
+            }
+
+            __m128i dst = _mm_loadu_si128((const __m128i*)(dest_pixel + x));
+
+            __m128i src_lo = _mm_cvtepu8_epi16(src);
+            __m128i src_hi = _mm_cvtepu8_epi16(_mm_srli_si128(src, 8));
+            __m128i dst_lo = _mm_cvtepu8_epi16(dst);
+            __m128i dst_hi = _mm_cvtepu8_epi16(_mm_srli_si128(dst, 8));
+
+            __m128i inv_a_lo = _mm_sub_epi16(c255, _mm_shuffle_epi8(src_lo, alpha_shuffle));
+            __m128i inv_a_hi = _mm_sub_epi16(c255, _mm_shuffle_epi8(src_hi, alpha_shuffle));
+
+            // d * (255 - a) / 255, rounded, then a saturating add of the premultiplied source
+            __m128i t_lo = _mm_add_epi16(_mm_mullo_epi16(dst_lo, inv_a_lo), c128);
+            __m128i t_hi = _mm_add_epi16(_mm_mullo_epi16(dst_hi, inv_a_hi), c128);
+            t_lo = _mm_srli_epi16(_mm_add_epi16(t_lo, _mm_srli_epi16(t_lo, 8)), 8);
+            t_hi = _mm_srli_epi16(_mm_add_epi16(t_hi, _mm_srli_epi16(t_hi, 8)), 8);
+
+            __m128i blended = _mm_or_si128(_mm_adds_epu8(src, _mm_packus_epi16(t_lo, t_hi)), alpha_bits);
+
+            // Keep the destination where alpha == 0
+            __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(src, alpha_bits), _mm_setzero_si128());
+            _mm_storeu_si128((__m128i*)(dest_pixel + x), _mm_blendv_epi8(blended, dst, transparent));
+        }
+        for (; x < width; ++x) {
+            dest_pixel[x] = blend_pixel(source_row[x], dest_pixel[x]);
+        }
+
+        dest_row += dest_pitch;
+        source_row += source_pitch;
+    }
+}
+
+// 24-bit rows: one byte shuffle turns 4 BGR triples into 4 ARGB pixels
+static void expand_bgr_pixels_sse41(uint32_t* dest, const uint8_t* source, int count) {
+    const __m128i alpha_bits = _mm_set1_epi32((int)0xFF000000);
+    const __m128i bgr_shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+    // Each load reads 16 bytes but uses 12: stop while 16 bytes are still inside the row
+    int i = 0;
+    for (; i + 6 <= count; i += 4) {
+        __m128i bgr = _mm_loadu_si128((const __m128i*)(source + 3 * i));
+        _mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(_mm_shuffle_epi8(bgr, bgr_shuffle), alpha_bits));
+    }
+    for (; i < count; ++i) {
+        const uint8_t* pixel = source + 3 * i;
+        dest[i] = 0xFF000000 | ((uint32_t)pixel[2] << 16) | ((uint32_t)pixel[1] << 8) | pixel[0];
+    }
+}
+
+void kernels_bind_sse41(EngineKernels* table) {
+    table->isa = CPU_ISA_SSE41;
+    table->blend_pixels = blend_pixels_sse41;
+    table->expand_bgr_pixels = expand_bgr_pixels_sse41;
+}
+
+#else
+
+void kernels_bind_sse41(EngineKernels* table) {
+    (void)table;
+}
+
+#endif // CPU_X86
@@ -3,6 +3,19 @@
 #include <stdio.h> // Required for fopen, fseek, fread
 #include <dsound.h> // Required for DirectSound
 #include <math.h>   // Required for math functions like sin, cos
+#include <string.h> // Required for memset, memcpy
+#include <stdlib.h> // Required for getenv
+#include <stdarg.h> // Required for va_list (stats overlay)
+
+#include "audio_resampler.h"
+#include "kernels.h"
+#include "job_system.h"
+#include "render.h"
+#include "text.h"
+#include "particles.h"
+#include "bmp.h"
+#include "world.h"
+#include "rewind.h"
 
 // Definición de PI por si acaso no está
 #ifndef M_PI
@@ -18,34 +31,70 @@ typedef HRESULT(WINAPI* direct_sound_create)(LPCGUID, LPDIRECTSOUND*, LPUNKNOWN)
 //                          Engine Types
 // ##################################################################
 
-// Represents the game's back buffer (framebuffer)
-// Contains the pixel data and dimensions for drawing
-struct GameBuffer {
-    void* memory;       // Pointer to pixel data
-    int width;          // Screen width in pixels
-    int height;         // Screen height in pixels
-    int pitch;          // Bytes per scanline (width * 4 for 32-bit)
-};
-
 // Tracks the state of a single input button/key
 struct ButtonState {
-    bool is_down;       // Whether the button is currently pressed
-    bool changed;       // Whether the state changed this frame
+    bool is_down;               // Whether the button is currently pressed
+    bool changed;               // Whether the state changed this frame
+    int half_transition_count;  // Presses + releases seen this frame (press+release = 2)
+};
+
+// Logical buttons, used to index GameInput::buttons and tag input events
+enum InputButton {
+    INPUT_BUTTON_UP,
+    INPUT_BUTTON_DOWN,
+    INPUT_BUTTON_LEFT,
+    INPUT_BUTTON_RIGHT,
+    INPUT_BUTTON_REWIND,
+    INPUT_BUTTON_DEBUG_OVERDRAW,
+    INPUT_BUTTON_DEBUG_STATS,
+    INPUT_BUTTON_DEBUG_PARTICLES,
+    INPUT_BUTTON_COUNT
+};
+
+// A single press or release, in the order the platform received it
+struct InputEvent {
+    InputButton button;     // Which button changed
+    bool is_down;           // New state of the button
+    int64_t timestamp;      // High-resolution counter value when the OS queued the event
 };
 
+// Maximum events kept per frame (extra events still update the button states)
+#define MAX_INPUT_EVENTS 64
+
 // Contains the state of all input buttons
 struct GameInput {
-    ButtonState up;     // Up arrow or W key
-    ButtonState down;   // Down arrow or S key
-    ButtonState left;   // Left arrow or A key
-    ButtonState right;  // Right arrow or D key
+    union {
+        ButtonState buttons[INPUT_BUTTON_COUNT];
+        struct {
+            ButtonState up;     // Up arrow or W key
+            ButtonState down;   // Down arrow or S key
+            ButtonState left;   // Left arrow or A key
+            ButtonState right;  // Right arrow or D key
+            ButtonState rewind; // Backspace: hold to run time backwards
+            ButtonState debug_overdraw; // F1: toggles the overdraw heatmap
+            ButtonState debug_stats;    // F2: toggles the stats overlay
+            ButtonState debug_particles; // F3: toggles the particle stress test
+        };
+    };
+
+    // Every transition since the last frame, oldest first
+    InputEvent events[MAX_INPUT_EVENTS];
+    int event_count;
+};
+
+// Input-to-present latency, measured from each event's timestamp to the end of the blit
+struct InputLatencyStats {
+    float last_ms;          // Latency of the most recent event
+    float average_ms;       // Exponential moving average
+    float max_ms;           // Worst case since startup
+    uint32_t event_count;   // Events measured
 };
 
-// Represents a loaded bitmap/image in memory
-struct LoadedBitmap {
-    int width;          // Image width in pixels
-    int height;         // Image height in pixels
-    uint32_t* pixels;   // Pointer to pixel color data (ARGB format)
+// Cost of the rewind history, in performance counter ticks
+struct RewindStats {
+    float snapshot_counts;  // Save + encode of one tick (exponential moving average)
+    float restore_counts;   // Decode + load of the last step back
+    int64_t ticks_restored; // Steps back since startup
 };
 
 // Structure for returning raw file data from disk
@@ -73,12 +122,6 @@ struct GameState{
     bool is_grounded;
 };
 
-struct AABB {
-    float x, y;
-    float w, h;
-};
-
-
 // ##################################################################
 //                          Platform Globals
 // ##################################################################
@@ -91,8 +134,91 @@ static GameBuffer global_back_buffer;
 
 static GameSoundOutput global_sound_output;
 
+// Mixes sound assets of any sample rate into the output stream
+static SoundMixer global_sound_mixer;
+
 static GameState game_state;
 
+// Level geometry (world space) and the camera that looks at it
+static World game_world;
+static Camera game_camera;
+static CullStats global_cull_stats;
+
+// Nivel de prueba: varias pantallas de ancho, con plataformas al azar
+#define LEVEL_SCREENS 16
+#define LEVEL_OBJECTS_PER_SCREEN 12
+#define LEVEL_GROUND_Y 500.0f
+#define PLAYER_SIZE 64.0f // Asumiendo que tu héroe mide 64x64
+
+// Running input latency measurement
+static InputLatencyStats global_input_latency;
+
+// Worker threads (one per core) for parallel engine tasks
+static JobSystem global_job_system;
+
+// Glyph atlas + layout cache for on-screen text
+static TextRenderer global_text;
+
+// Debug overlay with frame/engine stats (toggled with F2)
+static bool global_show_stats = true;
+
+// Particle effects: landing dust (alpha) and the sparks fountain on the wall (additive)
+static ParticlePool global_dust;
+static ParticlePool global_sparks;
+static ParticleEmitter dust_emitter;
+static ParticleEmitter sparks_emitter;
+
+// Sparks fountain rates: normal and stress test (F3, ~100k live particles)
+#define SPARKS_RATE 400.0f
+#define SPARKS_STRESS_RATE 80000.0f
+
+// Rewind: the whole simulation state is snapshotted every tick (Backspace plays it backwards)
+static RewindBuffer global_rewind;
+static RewindStats global_rewind_stats;
+
+// Rewind history budget: 32 MB of deltas, up to 10 minutes at 60 ticks per second
+#define REWIND_RING_SIZE (32u << 20)
+#define REWIND_MAX_TICKS (60 * 60 * 10)
+
+// Largest snapshot: player, both emitters and both full particle pools
+#define GAME_STATE_MAX_SIZE (sizeof(GameState) + 2 * sizeof(ParticleEmitter) + 2 * PARTICLE_STATE_MAX_SIZE)
+
+// ##################################################################
+//                          Input Helpers
+// ##################################################################
+
+// Applies a press/release to its button and appends it to the frame's event queue
+void record_button_event(GameInput* input, InputButton button, bool is_down, int64_t timestamp) {
+    ButtonState* state = &input->buttons[button];
+    if (state->is_down == is_down) return; // Not a transition (e.g. key repeat)
+
+    state->is_down = is_down;
+    state->changed = true;
+    state->half_transition_count++;
+
+    if (input->event_count < MAX_INPUT_EVENTS) {
+        InputEvent* event = &input->events[input->event_count++];
+        event->button = button;
+        event->is_down = is_down;
+        event->timestamp = timestamp;
+    }
+}
+
+// Clears per-frame transitions and the event queue, keeping which buttons are held
+void begin_input_frame(GameInput* input) {
+    for (int i = 0; i < INPUT_BUTTON_COUNT; ++i) {
+        input->buttons[i].changed = false;
+        input->buttons[i].half_transition_count = 0;
+    }
+    input->event_count = 0;
+}
+
+// True if the button went down at any point this frame, even if it was released again
+bool button_was_pressed(ButtonState* state) {
+    return (state->half_transition_count > 1) ||
+           (state->half_transition_count == 1 && state->is_down);
+}
+
 // ##################################################################
 //                  Platform Functions Declarations
 // ##################################################################
@@ -135,6 +261,9 @@ static BITMAPINFO bitmap_info;
 // The loaded hero/player bitmap
 static LoadedBitmap hero_bitmap;
 
+// Jump sound effect (authored at 22.05 kHz, resampled by the mixer)
+static LoadedSound jump_sound;
+
 // Puntero global al buffer donde escribiremos el audio
 static LPDIRECTSOUNDBUFFER global_secondary_buffer;
 
@@ -208,6 +337,14 @@ void win32_init_dsound(HWND window, int32_t samples_per_second, int32_t buffer_s
     }
 }
 
+// Generates sample_count stereo frames (test tone + mixer voices) into a locked region
+void win32_write_sound_samples(GameSoundOutput* sound_output, int16_t* sample_out, DWORD sample_count) {
+    float phase_step = 2.0f * M_PI * 256.0f / (float)sound_output->samples_per_second;
+    mixer_write_samples(&global_sound_mixer, sample_out, sample_count,
+                        &sound_output->t_sine, phase_step, 3000.0f); // 3000 es el volumen (Max 32000)
+    sound_output->running_sample_index += sample_count;
+}
+
 void win32_fill_sound_buffer(GameSoundOutput* sound_output, DWORD byte_to_lock, DWORD bytes_to_write) {
     VOID* region1;
     DWORD region1_size;
@@ -222,44 +359,12 @@ void win32_fill_sound_buffer(GameSoundOutput* sound_output, DWORD byte_to_lock,
         0))) {
 
         // Llenar región 1
-        int16_t* sample_out = (int16_t*)region1;
         DWORD region1_sample_count = region1_size / sound_output->bytes_per_sample;
-
-        for (DWORD i = 0; i < region1_sample_count; ++i) {
-            float sine_value = sinf(sound_output->t_sine);
-            int16_t sample_value = (int16_t)(sine_value * 3000); // 3000 es el volumen (Max 32000)
-
-            // Escribir muestra en ambos canales (stereo)
-            *sample_out++ = sample_value; // Canal izquierdo
-            *sample_out++ = sample_value; // Canal derecho
-            
-            //Avanzamos el oscilador
-            sound_output->t_sine += 2.0f * M_PI * 256.0f / (float)sound_output->samples_per_second;
-            if(sound_output ->t_sine > 2.0f * M_PI) {
-                sound_output->t_sine -= 2.0f * M_PI;
-            }
-            sound_output->running_sample_index++;
-        }
+        win32_write_sound_samples(sound_output, (int16_t*)region1, region1_sample_count);
 
         // Llenar región 2 si existe
-        sample_out = (int16_t*)region2;
         DWORD region2_sample_count = region2_size / sound_output->bytes_per_sample;
-
-        for (DWORD i = 0; i < region2_sample_count; ++i) {
-            float sine_value = sinf(sound_output->t_sine);
-            int16_t sample_value = (int16_t)(sine_value * 3000); // Volumen
-
-            *sample_out++ = sample_value; // Canal izquierdo
-            *sample_out++ = sample_value; // Canal derecho
-
-
-            sound_output->t_sine += 2.0f * M_PI * 256.0f / (float)sound_output->samples_per_second;
-            if(sound_output ->t_sine > 2.0f * M_PI) {
-                sound_output->t_sine -= 2.0f * M_PI;
-            }
-            sound_output->running_sample_index++;
-
-        }
+        win32_write_sound_samples(sound_output, (int16_t*)region2, region2_sample_count);
 
         global_secondary_buffer->Unlock(region1, region1_size, region2, region2_size);
     }
@@ -346,20 +451,39 @@ bool platform_create_window(int width, int height, const char* title)
     return true;
 }
 
+// Returns the current value of the high-resolution performance counter
+int64_t win32_get_wall_clock() {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+// Converts a message time (GetMessageTime: GetTickCount milliseconds) to the performance counter,
+// by aging the counter value read now. Tick resolution is ~10-16 ms, so the result is that coarse
+int64_t win32_message_time_to_counter(DWORD message_time, DWORD now_ticks, int64_t now_counter,
+                                      int64_t perf_count_frequency) {
+    DWORD age_ms = now_ticks - message_time; // Unsigned difference survives the 49.7-day wraparound
+    if (age_ms > 0x7FFFFFFF) age_ms = 0;     // Stamped after our tick read: treat as just arrived
+
+    int64_t timestamp = now_counter - (int64_t)age_ms * perf_count_frequency / 1000;
+    return (timestamp < now_counter) ? timestamp : now_counter;
+}
+
 // Processes a single keyboard button event
-void win32_process_keyboard_message(ButtonState* new_state, bool is_down) {
-    if (new_state->is_down != is_down) {
-        // State changed this frame
-        new_state->is_down = is_down;
-        new_state->changed = true;
-    } else {
-        // State unchanged
-        new_state->changed = false;
-    }
+void win32_process_keyboard_message(GameInput* input, InputButton button, bool is_down, bool was_down,
+                                    int64_t timestamp) {
+    // Auto-repeat messages arrive as WM_KEYDOWN with the key already down: they are not transitions
+    if (is_down && was_down) return;
+
+    record_button_event(input, button, is_down, timestamp);
 }
 
 // Processes all pending window messages (input events, etc.)
+// Can be called several times per frame: events accumulate until begin_input_frame
 void platform_update_window(GameInput* input){
+    LARGE_INTEGER perf_count_frequency;
+    QueryPerformanceFrequency(&perf_count_frequency);
+
     MSG msg;
     while(PeekMessageA(&msg, window, 0, 0, PM_REMOVE)){
         switch(msg.message) {
@@ -367,13 +491,22 @@ void platform_update_window(GameInput* input){
             case WM_KEYDOWN:
             case WM_KEYUP: {
                 bool is_down = (msg.message == WM_KEYDOWN);
+                bool was_down = ((msg.lParam & (1 << 30)) != 0); // Bit 30: previous key state
                 uint32_t vk_code = (uint32_t)msg.wParam;
 
+                // Stamp with the time the OS queued the message, not when we got around to reading it
+                int64_t timestamp = win32_message_time_to_counter(msg.time, GetTickCount(), win32_get_wall_clock(),
+                                                                  perf_count_frequency.QuadPart);
+
                 // Map virtual key codes to input buttons
-                if (vk_code == VK_UP)    win32_process_keyboard_message(&input->up, is_down);
-                else if (vk_code == VK_DOWN)  win32_process_keyboard_message(&input->down, is_down);
-                else if (vk_code == VK_LEFT)  win32_process_keyboard_message(&input->left, is_down);
-                else if (vk_code == VK_RIGHT) win32_process_keyboard_message(&input->right, is_down);
+                if (vk_code == VK_UP)    win32_process_keyboard_message(input, INPUT_BUTTON_UP, is_down, was_down, timestamp);
+                else if (vk_code == VK_DOWN)  win32_process_keyboard_message(input, INPUT_BUTTON_DOWN, is_down, was_down, timestamp);
+                else if (vk_code == VK_LEFT)  win32_process_keyboard_message(input, INPUT_BUTTON_LEFT, is_down, was_down, timestamp);
+                else if (vk_code == VK_RIGHT) win32_process_keyboard_message(input, INPUT_BUTTON_RIGHT, is_down, was_down, timestamp);
+                else if (vk_code == VK_BACK)  win32_process_keyboard_message(input, INPUT_BUTTON_REWIND, is_down, was_down, timestamp);
+                else if (vk_code == VK_F1)    win32_process_keyboard_message(input, INPUT_BUTTON_DEBUG_OVERDRAW, is_down, was_down, timestamp);
+                else if (vk_code == VK_F2)    win32_process_keyboard_message(input, INPUT_BUTTON_DEBUG_STATS, is_down, was_down, timestamp);
+                else if (vk_code == VK_F3)    win32_process_keyboard_message(input, INPUT_BUTTON_DEBUG_PARTICLES, is_down, was_down, timestamp);
             } break;
 
             // Other messages (translate and dispatch)
@@ -385,6 +518,25 @@ void platform_update_window(GameInput* input){
     }
 }
 
+// Records the latency of every event consumed this frame, now that it has been presented
+void win32_record_input_latency(GameInput* input, int64_t present_counter, long long perf_count_frequency) {
+    InputLatencyStats* stats = &global_input_latency;
+
+    for (int i = 0; i < input->event_count; ++i) {
+        int64_t elapsed = present_counter - input->events[i].timestamp;
+        float ms = 1000.0f * (float)elapsed / (float)perf_count_frequency;
+
+        stats->last_ms = ms;
+        if (ms > stats->max_ms) stats->max_ms = ms;
+        if (stats->event_count == 0) {
+            stats->average_ms = ms;
+        } else {
+            stats->average_ms += (ms - stats->average_ms) * 0.1f;
+        }
+        stats->event_count++;
+    }
+}
+
 // Copies the back buffer to the screen for display
 void platform_blit_to_window() {
     HDC device_context = GetDC(window);
@@ -436,35 +588,21 @@ ReadResult debug_read_entire_file(const char* filename) {
     return result;
 }
 
-// Loads a BMP image file and returns it as a LoadedBitmap
+// Loads a BMP image file and returns it as a LoadedBitmap (top-down, premultiplied)
+// Returns an empty bitmap if the file is missing or not a supported BMP
 LoadedBitmap debug_load_bmp(const char* filename) {
     LoadedBitmap result = {};
     ReadResult file = debug_read_entire_file(filename);
 
     if (file.content && file.content_size > 0) {
-        // Parse BMP file headers
-        BITMAPFILEHEADER* file_header = (BITMAPFILEHEADER*)file.content;
-        BITMAPINFOHEADER* info_header = (BITMAPINFOHEADER*)((uint8_t*)file.content + sizeof(BITMAPFILEHEADER));
-
-        // --- SAFETY VALIDATION ---
-        // Only 32-bit BMPs are supported (with alpha channel)
-        if (info_header->biBitCount != 32) {
-            std::cout << "ERROR: BMP file is not 32-bit (" << info_header->biBitCount << " bits detected)." << std::endl;
-            std::cout << "Please save the image as a '32-bit bitmap' (with Alpha channel)." << std::endl;
-            // Free file memory since we won't use it
-            free_file_memory(file.content);
-            return result; // Return empty (will trigger fallback in main)
+        BmpError error = bmp_decode(file.content, file.content_size, &result);
+        if (error != BMP_OK) {
+            std::cout << "ERROR: could not decode " << filename << ": " << bmp_error_name(error) << std::endl;
         }
-        // -------------------------
-
-        // Extract dimensions
-        result.width = info_header->biWidth;
-        result.height = info_header->biHeight;
-        
-        // Point to pixel data (starts after BMP headers)
-        result.pixels = (uint32_t*)((uint8_t*)file.content + file_header->bfOffBits);
     }
-    
+
+    // The decoded bitmap owns its pixels: the file is no longer needed
+    free_file_memory(file.content);
     return result;
 }
 
@@ -475,213 +613,49 @@ LoadedBitmap debug_load_bmp(const char* filename) {
 //                          Main (Game Logic)
 // ##################################################################
 
-// Creates a procedural test bitmap (checkerboard pattern)
-// Useful as a fallback when image files fail to load
-LoadedBitmap make_test_bitmap(int width, int height) {
-    LoadedBitmap bmp = {};
-    bmp.width = width;
-    bmp.height = height;
-    
-    // Allocate memory for pixel data (4 bytes per pixel for ARGB)
-    int size = width * height * 4;
-    bmp.pixels = (uint32_t*)VirtualAlloc(0, size, MEM_COMMIT, PAGE_READWRITE);
-
-    // Fill pixels with checkerboard pattern
-    uint32_t* pixel_ptr = bmp.pixels;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Checkerboard: divide by 8 and check if sum is even/odd
-            bool black = ((x / 8) + (y / 8)) % 2 == 0;
-            
-            if (black) {
-                *pixel_ptr = 0xFF000000; // Black
-            } else {
-                *pixel_ptr = 0xFFFF00FF; // Bright magenta
-            }
-            pixel_ptr++;
-        }
-    }
-    return bmp;
-}
-
-// Draws a solid filled rectangle to the back buffer
-// Parameters: buffer (target), x/y (position), width/height (size), color (ARGB)
-void draw_rect(GameBuffer* buffer, int x, int y, int width, int height, uint32_t color) {
-    int min_x = x;
-    int min_y = y;
-    int max_x = x + width;
-    int max_y = y + height;
-
-    // Clipping: ensure rectangle stays within screen bounds
-    if (min_x < 0) min_x = 0;
-    if (min_y < 0) min_y = 0;
-    if (max_x > buffer->width) max_x = buffer->width;
-    if (max_y > buffer->height) max_y = buffer->height;
-
-    // Pointer to the start of the rectangle in the back buffer
-    uint8_t* row = (uint8_t*)buffer->memory;
-    row += min_y * buffer->pitch + min_x * 4;
-
-    // Fill each scanline of the rectangle
-    for (int cy = min_y; cy < max_y; ++cy) {
-        uint32_t* pixel = (uint32_t*)row;
-        for (int cx = min_x; cx < max_x; ++cx) {
-            *pixel = color;
-            pixel++;
-        }
-        row += buffer->pitch;
-    }
-}
-
-bool check_aabb_collision(AABB a, AABB b) {
-    // Si A está a la izquierda de B
-    if (a.x + a.w < b.x) return false;
-    // Si A está a la derecha de B
-    if (a.x > b.x + b.w) return false;
-    // Si A está arriba de B
-    if (a.y + a.h < b.y) return false;
-    // Si A está abajo de B
-    if (a.y > b.y + b.h) return false;
-    
-    // Si no se cumple nada de lo anterior, se están tocando
-    return true;
-}
-
-// Draws a bitmap/sprite to the back buffer at the specified position
-// Supports clipping at screen edges
-void draw_bitmap(GameBuffer* buffer, LoadedBitmap* bitmap, int x, int y){
-    int min_x = x;
-    int min_y = y;
-    int max_x = x + bitmap->width;
-    int max_y = y + bitmap->height;
-
-    // Clipping calculation
-    // When we clip the draw area, we also need to know where to start
-    // reading from the source texture
-    int source_offset_x = 0;
-    int source_offset_y = 0;
-
-    if (min_x < 0) {
-        source_offset_x = -min_x; // Start further into the texture
-        min_x = 0;
-    }
-    if (min_y < 0) {
-        source_offset_y = -min_y;
-        min_y = 0;
-    }
-    if (max_x > buffer->width) max_x = buffer->width;
-    if (max_y > buffer->height) max_y = buffer->height;
-
-    // Calculate initial pointers
-    // Destination (screen):
-    uint8_t* dest_row = (uint8_t*)buffer->memory + (min_y * buffer->pitch) + (min_x * 4);
-
-    // Source (texture):
-    // The texture is linear and compact (pitch = width * 4)
-    uint32_t* source_row = bitmap->pixels + (source_offset_y * bitmap->width) + source_offset_x;
-    
-    // Copy each scanline
-    for (int cy = min_y; cy < max_y; ++cy) {
-        uint32_t* dest_pixel = (uint32_t*)dest_row;
-        uint32_t* source_pixel = source_row;
-
-        // Copy each pixel in the scanline
-        for (int cx = min_x; cx < max_x; ++cx) {
-            // Simple copy (no transparency blending yet)
-            // Read from texture -> Write to screen
-            *dest_pixel = *source_pixel;
-
-            dest_pixel++;
-            source_pixel++;
-        }
-        
-        // Advance to next scanline
-        dest_row += buffer->pitch;
-        source_row += bitmap->width; // Texture pitch is simply the width
-    }
-}
-
-void draw_bitmap_alpha(GameBuffer* buffer, LoadedBitmap* bitmap, float x, float y){
-    int min_x = (int)x;
-    int min_y = (int)y;
-    int max_x = min_x + bitmap->width;
-    int max_y = min_y + bitmap->height;
-
-
-    // Clipping calculation
-    int source_offset_x = 0;
-    int source_offset_y = 0;
-
-    if(min_x < 0 ) { source_offset_x = -min_x; min_x = 0; }
-    if(min_y < 0 ) { source_offset_y = -min_y; min_y = 0; }
-    if(max_x > buffer->width )  max_x = buffer->width;
-    if(max_y > buffer->height ) max_y = buffer->height;
-
-
-    uint8_t* dest_row = (uint8_t*)buffer->memory + (min_y * buffer->pitch) + (min_x * 4);
-    uint32_t* source_row = bitmap->pixels + (source_offset_y * bitmap->width) + source_offset_x;
-
-
-    for(int cy = min_y; cy < max_y; ++cy) {
-        uint32_t* dest_pixel = (uint32_t*)dest_row;
-        uint32_t* source_pixel = source_row;
-
-        for(int cx = min_x; cx < max_x; ++cx) {
-            uint32_t src_color = *source_pixel;
-
-            // Extract alpha component
-            uint8_t alpha = (src_color >> 24) & 0xFF;
-
-            if (alpha == 0){
-
-            }
-            else if (alpha == 255){
-                *dest_pixel = src_color;
-            }
-            else {
-                float a = (float)alpha / 255.0f;
-                uint8_t src_r = (src_color >> 16) & 0xFF;
-                uint8_t src_g = (src_color >> 8) & 0xFF;
-                uint8_t src_b = src_color & 0xFF;
-
-                uint32_t dst_color = *dest_pixel;
-                uint8_t dst_r = (dst_color >> 16) & 0xFF;
-                uint8_t dst_g = (dst_color >> 8) & 0xFF;
-                uint8_t dst_b = dst_color & 0xFF;
-
-                uint8_t final_r = (uint8_t)((src_r * a) + (dst_r * (1.0f - a)));
-                uint8_t final_g = (uint8_t)((src_g * a) + (dst_g * (1.0f - a)));
-                uint8_t final_b = (uint8_t)((src_b * a) + (dst_b * (1.0f - a)));
-
-                *dest_pixel = (0xFF << 24) | (final_r << 16) | (final_g << 8) | final_b;
-            }
-            dest_pixel++;
-            source_pixel++;
-        }
-        dest_row += buffer->pitch;
-        source_row += bitmap->width;
+// Builds a test level: the original wall (object 0) plus random platforms and background blocks
+// screens = level width in 1280-pixel screens, objects_per_screen keeps the density constant
+bool make_test_level(World* world, int screens, int objects_per_screen, uint32_t seed) {
+    float level_width = 1280.0f * (float)screens;
+    int object_count = 1 + screens * objects_per_screen;
+
+    // Dos pantallas de alto: el suelo abajo, el cielo arriba
+    if (!world_init(world, level_width, -720.0f, 1440.0f, object_count)) return false;
+
+    AABB wall = { 600.0f, 400.0f, 100.0f, 200.0f };
+    world_add_object(world, wall, 0xFF888888);
+
+    uint32_t state = seed ? seed : 1;
+    for (int i = 1; i < object_count; ++i) {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        AABB box;
+        box.w = (float)(80 + (state & 0xFF));                      // 80..335
+        box.h = (float)(16 + ((state >> 8) & 0x1F));               // 16..47
+        box.x = 800.0f + (float)((state >> 13) % (uint32_t)(level_width - 1000.0f));
+        box.y = LEVEL_GROUND_Y - 120.0f - (float)((state >> 3) % 520); // Siempre se puede pasar por debajo
+        uint32_t shade = 0x50 + ((state >> 24) & 0x3F);
+        world_add_object(world, box, 0xFF000000 | (shade << 16) | (shade << 8) | (shade + 0x20));
     }
+    return world_build_grid(world);
 }
-void game_update_and_render(GameBuffer* buffer, GameInput* input, float dt) {
-
-    // 1. Limpiar pantalla
-    draw_rect(buffer, 0, 0, buffer->width, buffer->height, 0xFF333333);
 
-    // 2. Definir Paredes y Constantes
-    float wall_x = 600.0f; // Coincide con tu AABB wall
-    float wall_y = 400.0f;
-    int wall_w = 100;
-    int wall_h = 200;
+// Advances the simulation one tick
+void game_update(GameInput* input, float dt) {
 
+    // Constantes (todas las posiciones están en coordenadas de mundo)
     float gravity = 2000.0f;    
     float jump_force = -900.0f; 
     float run_speed = 400.0f;   
-    float ground_y = 500.0f;    
+    float ground_y = LEVEL_GROUND_Y;
 
-    // Definimos las cajas (Hitboxes)
-    AABB wall = { wall_x, wall_y, (float)wall_w, (float)wall_h };
-    float player_w = 64.0f; // Asumiendo que tu héroe mide 64x64
-    float player_h = 64.0f;
+    // La pared original es el objeto 0 del nivel
+    AABB wall = game_world.objects[0].box;
+    float player_w = PLAYER_SIZE;
+    float player_h = PLAYER_SIZE;
 
     // ---------------------------------------------------------
     // ¡ESTO FALTABA! CONEXIÓN INPUT -> FÍSICA
@@ -698,21 +672,36 @@ void game_update_and_render(GameBuffer* buffer, GameInput* input, float dt) {
         game_state.player_vel_x = run_speed;
     }
 
+    // F3: stress test del sistema de partículas
+    if (button_was_pressed(&input->debug_particles)) {
+        sparks_emitter.rate = (sparks_emitter.rate == SPARKS_RATE) ? SPARKS_STRESS_RATE : SPARKS_RATE;
+    }
+
+    // Para detectar el aterrizaje (polvo)
+    bool was_grounded = game_state.is_grounded;
+
     // Salto
-    if (input->up.is_down && input->up.changed && game_state.is_grounded) {
+    // Usamos las transiciones: un toque rápido (press + release en el mismo frame) también salta
+    if (button_was_pressed(&input->up) && game_state.is_grounded) {
         game_state.player_vel_y = jump_force;
         game_state.is_grounded = false;
+        mixer_play_sound(&global_sound_mixer, &jump_sound, 1.0f, 1.0f, false);
     }
 
     // ---------------------------------------------------------
     // INTEGRACIÓN DE FÍSICA Y COLISIONES
     // ---------------------------------------------------------
 
+    // Solo se prueban los objetos de las celdas alrededor del jugador (grilla del nivel)
+    int hits[16];
+
     // --- A. MOVIMIENTO HORIZONTAL (Eje X) ---
     float next_x = game_state.player_x + (game_state.player_vel_x * dt);
     AABB player_box_x = { next_x, game_state.player_y, player_w, player_h };
-    
-    if (check_aabb_collision(player_box_x, wall)) {
+    bool outside_level = next_x < 0.0f || next_x + player_w > game_world.width;
+
+    // world_query no cuenta los bordes que solo se tocan: parados sobre una plataforma podemos caminar
+    if (outside_level || world_query(&game_world, player_box_x, hits, 16) > 0) {
         // Choque lateral: Frenamos en seco
         game_state.player_vel_x = 0;
     } else {
@@ -725,19 +714,29 @@ void game_update_and_render(GameBuffer* buffer, GameInput* input, float dt) {
     float next_y = game_state.player_y + (game_state.player_vel_y * dt);
     
     AABB player_box_y = { game_state.player_x, next_y, player_w, player_h };
+    int hit_count = world_query(&game_world, player_box_y, hits, 16);
 
-    if (check_aabb_collision(player_box_y, wall)) {
-        // Choque vertical con la pared (Techo o Plataforma)
+    if (hit_count > 0) {
+        // Choque vertical con el nivel (Techo o Plataforma)
         if (game_state.player_vel_y > 0) {
-            // Caíamos: Aterrizamos sobre la caja
+            // Caíamos: Aterrizamos sobre la caja más alta que tocamos
             // Ajuste fino: Nos posamos exactamente encima
-            game_state.player_y = wall.y - player_h; 
+            float top = game_world.objects[hits[0]].box.y;
+            for (int i = 1; i < hit_count; ++i) {
+                if (game_world.objects[hits[i]].box.y < top) top = game_world.objects[hits[i]].box.y;
+            }
+            game_state.player_y = top - player_h; 
             game_state.player_vel_y = 0;
             game_state.is_grounded = true;
         } else {
-            // Saltábamos: Nos dimos la cabeza contra la caja
+            // Saltábamos: Nos dimos la cabeza contra la caja más baja
             // Ajuste fino: Nos quedamos justo debajo
-            game_state.player_y = wall.y + wall.h;
+            float bottom = game_world.objects[hits[0]].box.y + game_world.objects[hits[0]].box.h;
+            for (int i = 1; i < hit_count; ++i) {
+                AABB box = game_world.objects[hits[i]].box;
+                if (box.y + box.h > bottom) bottom = box.y + box.h;
+            }
+            game_state.player_y = bottom;
             game_state.player_vel_y = 0;
         }
     } else {
@@ -755,20 +754,209 @@ void game_update_and_render(GameBuffer* buffer, GameInput* input, float dt) {
         }
     }
 
+    // ---------------------------------------------------------
+    // PARTÍCULAS (misma gravedad que el jugador)
+    // ---------------------------------------------------------
+
+    // Aterrizaje: nube de polvo en los pies
+    if (!was_grounded && game_state.is_grounded) {
+        dust_emitter.x = game_state.player_x + 0.5f * player_w;
+        dust_emitter.y = game_state.player_y + player_h;
+        particles_burst(&global_dust, &dust_emitter, 40);
+    }
+
+    // La fuente de chispas sale de la esquina superior de la pared
+    sparks_emitter.x = wall.x + 0.5f * wall.w;
+    sparks_emitter.y = wall.y;
+    particles_emit(&global_sparks, &sparks_emitter, dt);
+
+    particles_update(&global_dust, dt, gravity * 0.1f); // El polvo casi flota
+    particles_update(&global_sparks, dt, gravity);
+}
+
+// Draws the current state (the camera is derived from it, so it is not part of the snapshots)
+void game_render(GameBuffer* buffer) {
+    float ground_y = LEVEL_GROUND_Y;
+    float player_w = PLAYER_SIZE;
+    float player_h = PLAYER_SIZE;
+
+    // Limpiar pantalla
+    draw_rect(buffer, 0, 0, buffer->width, buffer->height, 0xFF333333);
+
+    // ---------------------------------------------------------
+    // CÁMARA
+    // ---------------------------------------------------------
+
+    // Sigue al centro del jugador; todo lo que se dibuja pasa de mundo a pantalla restando su posición
+    game_camera.width = buffer->width;
+    game_camera.height = buffer->height;
+    camera_follow(&game_camera, &game_world, game_state.player_x + 0.5f * player_w,
+                  game_state.player_y + 0.5f * player_h);
+
     // ---------------------------------------------------------
     // RENDERIZADO
     // ---------------------------------------------------------
 
-    // Dibujar piso (Referencia)
-    draw_rect(buffer, 0, (int)ground_y, buffer->width, 50, 0xFF000000);
+    // Dibujar piso (Referencia): ocupa todo el ancho del nivel, así que va siempre de borde a borde
+    draw_rect(buffer, 0, (int)(ground_y - game_camera.y), buffer->width, 50, 0xFF000000);
 
-    // Dibujar pared
-    draw_rect(buffer, (int)wall.x, (int)wall.y, (int)wall.w, (int)wall.h, 0xFF888888);
+    // Dibujar nivel: solo los objetos dentro de la vista llegan a draw_rect
+    world_render(buffer, &game_world, &game_camera, &global_cull_stats);
 
     // Dibujar Jugador
     // NOTA: Borré el "- hero_bitmap.height" porque ya corregimos la lógica del suelo arriba.
     // Ahora game_state.player_y es la esquina superior izquierda real.
-    draw_bitmap_alpha(buffer, &hero_bitmap, game_state.player_x, game_state.player_y);
+    draw_bitmap_alpha(buffer, &hero_bitmap, game_state.player_x - game_camera.x, game_state.player_y - game_camera.y);
+
+    // Partículas encima de todo: el polvo tapa, las chispas suman luz
+    particles_render(buffer, &global_dust, game_camera.x, game_camera.y);
+    particles_render(buffer, &global_sparks, game_camera.x, game_camera.y);
+}
+
+// Writes everything game_update changes into one flat image. Sparks go before dust: the dust
+// pool is empty most of the time, so its size changes do not shift the rest of the image.
+size_t game_save_state(uint8_t* dest) {
+    uint8_t* out = dest;
+    memcpy(out, &game_state, sizeof(game_state));
+    out += sizeof(game_state);
+    memcpy(out, &sparks_emitter, sizeof(sparks_emitter));
+    out += sizeof(sparks_emitter);
+    memcpy(out, &dust_emitter, sizeof(dust_emitter));
+    out += sizeof(dust_emitter);
+    out += particles_save_state(&global_sparks, out);
+    out += particles_save_state(&global_dust, out);
+    return (size_t)(out - dest);
+}
+
+void game_load_state(const uint8_t* source) {
+    const uint8_t* in = source;
+    memcpy(&game_state, in, sizeof(game_state));
+    in += sizeof(game_state);
+    memcpy(&sparks_emitter, in, sizeof(sparks_emitter));
+    in += sizeof(sparks_emitter);
+    memcpy(&dust_emitter, in, sizeof(dust_emitter));
+    in += sizeof(dust_emitter);
+    in += particles_load_state(&global_sparks, in);
+    particles_load_state(&global_dust, in);
+}
+
+void game_update_and_render(GameBuffer* buffer, GameInput* input, float dt) {
+    RewindStats* stats = &global_rewind_stats;
+
+    // Backspace (mantener): el tiempo corre hacia atrás, un tick grabado por frame.
+    // Cuando se acaba la historia el juego sigue normalmente.
+    bool rewound = false;
+    if (input->rewind.is_down && global_rewind.ring) {
+        int64_t restore_begin = win32_get_wall_clock();
+        size_t image_size;
+        const uint8_t* image = rewind_step_back(&global_rewind, &image_size);
+        if (image) {
+            game_load_state(image);
+            stats->restore_counts = (float)(win32_get_wall_clock() - restore_begin);
+            stats->ticks_restored++;
+            rewound = true;
+        }
+    }
+
+    if (!rewound) {
+        game_update(input, dt);
+
+        // Snapshot of the tick just simulated
+        if (global_rewind.ring) {
+            int64_t snapshot_begin = win32_get_wall_clock();
+            size_t image_size = game_save_state(rewind_begin_snapshot(&global_rewind));
+            rewind_push(&global_rewind, image_size, dt);
+
+            float counts = (float)(win32_get_wall_clock() - snapshot_begin);
+            if (stats->snapshot_counts == 0.0f) {
+                stats->snapshot_counts = counts;
+            } else {
+                stats->snapshot_counts += (counts - stats->snapshot_counts) * 0.1f;
+            }
+        }
+    }
+
+    game_render(buffer);
+}
+
+// Pen of the stats overlay: each line is its own draw_text call, so it gets its own cached
+// layout (lines that did not change this frame hit the cache) and never exceeds one layout
+struct OverlayPen {
+    GameBuffer* buffer;
+    int x;
+    int y;
+    int glyph_count;
+};
+
+static void overlay_line(OverlayPen* pen, const char* format, ...) {
+    char line[TEXT_MAX_LAYOUT_CHARS + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    pen->glyph_count += draw_text(pen->buffer, &global_text, line, pen->x, pen->y);
+    pen->y += global_text.font.line_height;
+}
+
+// Draws the stats overlay in the top-left corner. frame_ms is the work time of the previous frame.
+void draw_debug_stats(GameBuffer* buffer, float frame_ms, long long perf_count_frequency) {
+    // Timing of the overlay itself, shown on the next frame
+    static int last_glyph_count;
+    static float last_text_ms;
+    static uint32_t last_layout_misses;
+
+    LARGE_INTEGER text_begin;
+    QueryPerformanceCounter(&text_begin);
+    uint32_t misses_begin = global_text.cache_misses;
+
+    // The overlay's own text goes through the instrumented draw functions too: take the totals of the
+    // game's frame before the first line is drawn
+    DrawFunctionStats frame_stats[DRAW_FUNCTION_COUNT];
+    memcpy(frame_stats, global_overdraw.stats, sizeof(frame_stats));
+
+    OverlayPen pen = { buffer, 8, 8, 0 };
+    overlay_line(&pen, "FRAME %.2f MS (%.0f FPS)", frame_ms, frame_ms > 0.0f ? 1000.0f / frame_ms : 0.0f);
+    overlay_line(&pen, "KERNELS %s  THREADS %d", cpu_isa_name(global_kernels.isa), global_job_system.thread_count);
+    overlay_line(&pen, "INPUT LATENCY AVG %.1f MS  MAX %.1f MS",
+                 global_input_latency.average_ms, global_input_latency.max_ms);
+    overlay_line(&pen, "PARTICLES %d", global_dust.count + global_sparks.count);
+    overlay_line(&pen, "LEVEL %d OBJECTS  %d CANDIDATES  %d DRAWN",
+                 global_cull_stats.objects_in_world, global_cull_stats.candidates, global_cull_stats.visible);
+    overlay_line(&pen, "REWIND %.1f S  %.0f KB/S", global_rewind.history_seconds,
+                 rewind_bytes_per_second(&global_rewind) / 1024.0f);
+    overlay_line(&pen, "SNAPSHOT %u/%u B %.3f MS  RESTORE %.1f US",
+                 global_rewind.last_delta_size, global_rewind.last_image_size,
+                 1000.0f * global_rewind_stats.snapshot_counts / (float)perf_count_frequency,
+                 1000000.0f * global_rewind_stats.restore_counts / (float)perf_count_frequency);
+    overlay_line(&pen, "TEXT %d GLYPHS %.3f MS (%.0f GLYPHS/MS)  %u LAYOUT MISSES",
+                 last_glyph_count, last_text_ms,
+                 last_text_ms > 0.0f ? (float)last_glyph_count / last_text_ms : 0.0f, last_layout_misses);
+
+    // Overdraw totals of this frame (the heatmap itself was already blended in)
+    if (global_overdraw.enabled) {
+        uint64_t writes = 0;
+        for (int i = 0; i < DRAW_FUNCTION_COUNT; ++i) {
+            writes += frame_stats[i].pixels_filled + frame_stats[i].pixels_blended;
+        }
+        float writes_per_pixel = (float)writes / (float)(buffer->width * buffer->height);
+        overlay_line(&pen, "OVERDRAW %.2f WRITES/PIXEL", writes_per_pixel);
+
+        for (int i = 0; i < DRAW_FUNCTION_COUNT; ++i) {
+            DrawFunctionStats* stats = &frame_stats[i];
+            if (stats->calls == 0) continue;
+            overlay_line(&pen, "%s %u CALLS  %llu FILLED  %llu BLENDED  %llu SKIPPED  %llu CLIPPED",
+                         draw_function_name((DrawFunction)i), stats->calls,
+                         (unsigned long long)stats->pixels_filled, (unsigned long long)stats->pixels_blended,
+                         (unsigned long long)stats->pixels_skipped, (unsigned long long)stats->pixels_clipped);
+        }
+    }
+
+    LARGE_INTEGER text_end;
+    QueryPerformanceCounter(&text_end);
+    last_glyph_count = pen.glyph_count;
+    last_text_ms = 1000.0f * (float)(text_end.QuadPart - text_begin.QuadPart) / (float)perf_count_frequency;
+    last_layout_misses = global_text.cache_misses - misses_begin;
 }
 
 // Main entry point of the application
@@ -776,6 +964,27 @@ int main() {
     std::cout << "Initializing strangerEngine..." << std::endl;
     const char* title = "strangerEngine v0.5 - High Precision Loop";
 
+    // Pick the best pixel/audio kernels for this CPU
+    // STRANGER_ISA=scalar|sse2|sse41|avx2|avx512 forces a level (to test each variant on one machine)
+    CpuIsa requested_isa = CPU_ISA_AVX512;
+    const char* forced_isa = getenv("STRANGER_ISA");
+    if (forced_isa) {
+        requested_isa = cpu_isa_from_name(forced_isa);
+        if (requested_isa == CPU_ISA_COUNT) {
+            std::cout << "Unknown STRANGER_ISA '" << forced_isa << "', using autodetection." << std::endl;
+            requested_isa = CPU_ISA_AVX512;
+        }
+    }
+    CpuIsa active_isa = kernels_init(requested_isa);
+    std::cout << "Kernels: " << cpu_isa_name(active_isa) << std::endl;
+    if (forced_isa && active_isa != requested_isa) {
+        std::cout << "Requested ISA not supported by this CPU, clamped." << std::endl;
+    }
+
+    // Start the job system: this thread becomes thread 0 and helps while waiting
+    job_system_init(&global_job_system, 0);
+    std::cout << "Job system: " << global_job_system.thread_count << " threads." << std::endl;
+
     // Request high precision from Windows scheduler (1ms resolution)
     timeBeginPeriod(1);
 
@@ -797,6 +1006,9 @@ int main() {
     LARGE_INTEGER last_counter;
     QueryPerformanceCounter(&last_counter);
 
+    // Work time (without the limiter wait) of the previous frame, for the stats overlay
+    float last_frame_work_ms = 0.0f;
+
 
     // --- LOAD GAME ASSETS ---
     hero_bitmap = debug_load_bmp("C:\\Users\\thesu\\Desktop\\BizzottoProjects\\StrangerEngine\\test_hero.bmp");
@@ -822,6 +1034,11 @@ int main() {
     sound_output.latency_sample_count = sound_output.samples_per_second / 15; // 1/15 segundos de latencia
     // Buffer de 1 segundo
     sound_output.secondary_buffer_size = sound_output.samples_per_second * sound_output.bytes_per_sample; 
+
+    // Mezclador: cualquier asset se convierte a la frecuencia de salida al vuelo
+    resampler_init_tables();
+    global_sound_mixer.output_samples_per_second = sound_output.samples_per_second;
+    jump_sound = make_test_sound(22050, 0.25f);
     
     // Inicializamos DirectSound
     win32_init_dsound(window, sound_output.samples_per_second, sound_output.secondary_buffer_size);
@@ -835,6 +1052,47 @@ int main() {
         global_secondary_buffer->Play(0, 0, DSBPLAY_LOOPING);
     }
 
+    // Font atlas for the debug overlay (2x scale: 12x16 cells)
+    if (!text_init(&global_text, 2, 0xFFFFFFFF)) {
+        std::cout << "Could not allocate the font atlas." << std::endl;
+        global_show_stats = false;
+    }
+
+    // Partículas: pools de capacidad fija + emisores
+    if (!particles_init(&global_dust, 6, 0xB0A890, PARTICLE_BLEND_ALPHA) ||
+        !particles_init(&global_sparks, 4, 0xFFA040, PARTICLE_BLEND_ADDITIVE)) {
+        std::cout << "Could not allocate the particle pools." << std::endl;
+        return -1;
+    }
+
+    // Sin memoria para la historia se juega igual, solo que sin rebobinar
+    if (!rewind_init(&global_rewind, REWIND_RING_SIZE, REWIND_MAX_TICKS, GAME_STATE_MAX_SIZE)) {
+        std::cout << "Could not allocate the rewind history, rewind disabled." << std::endl;
+    }
+
+    dust_emitter.angle = -0.5f * M_PI;     // Hacia arriba
+    dust_emitter.spread = 1.4f;            // Casi un abanico horizontal
+    dust_emitter.speed_min = 40.0f;
+    dust_emitter.speed_max = 200.0f;
+    dust_emitter.life_min = 0.3f;
+    dust_emitter.life_max = 0.6f;
+    dust_emitter.random_state = 0x12345678u;
+
+    sparks_emitter.rate = SPARKS_RATE;
+    sparks_emitter.angle = -0.5f * M_PI;
+    sparks_emitter.spread = 0.5f;
+    sparks_emitter.speed_min = 600.0f;
+    sparks_emitter.speed_max = 1300.0f;
+    sparks_emitter.life_min = 1.0f;
+    sparks_emitter.life_max = 1.5f;
+    sparks_emitter.random_state = 0x9E3779B9u;
+
+    // --- NIVEL ---
+    if (!make_test_level(&game_world, LEVEL_SCREENS, LEVEL_OBJECTS_PER_SCREEN, 0xC0FFEE)) {
+        std::cout << "Could not allocate the level." << std::endl;
+        return -1;
+    }
+
     // --- INICIALIZACIÓN DEL JUEGO ---
     game_state.player_x = 100.0f;
     game_state.player_y = 100.0f;
@@ -877,6 +1135,8 @@ int main() {
         QueryPerformanceCounter(&work_counter_begin);
 
         // Process input events
+        // Last pump right before simulation; events that arrived while we waited
+        // for the previous frame are already queued with their own timestamps
         platform_update_window(&input);
         
         // Calculate delta time since last frame
@@ -890,9 +1150,26 @@ int main() {
         last_counter = work_counter_begin;
 
 
+        // F1: overdraw heatmap on/off
+        if (button_was_pressed(&input.debug_overdraw)) {
+            global_overdraw.enabled = !global_overdraw.enabled;
+        }
+
+        // F2: stats overlay on/off
+        if (button_was_pressed(&input.debug_stats) && global_text.font.atlas.pixels) {
+            global_show_stats = !global_show_stats;
+        }
+
         // Update and render game state
         if (global_back_buffer.memory) {
+            overdraw_begin_frame(&global_back_buffer);
             game_update_and_render(&global_back_buffer, &input, dt);
+            overdraw_end_frame(&global_back_buffer);
+
+            // Drawn after the heatmap so it stays readable (it reports the totals taken before its own text)
+            if (global_show_stats) {
+                draw_debug_stats(&global_back_buffer, last_frame_work_ms, perf_count_frequency);
+            }
         }
 
         // Display back buffer on screen
@@ -903,11 +1180,16 @@ int main() {
         // --- HYBRID FPS LIMITER (Secret to smooth rendering) ---
         LARGE_INTEGER work_counter_end;
         QueryPerformanceCounter(&work_counter_end);
+
+        // The frame is on screen: measure input latency, then start collecting the next frame's events
+        win32_record_input_latency(&input, work_counter_end.QuadPart, perf_count_frequency);
+        begin_input_frame(&input);
         
         // Calculate how long this frame took to render
         long long work_elapsed = work_counter_end.QuadPart - work_counter_begin.QuadPart;
         float seconds_elapsed_for_work = (float)work_elapsed / (float)perf_count_frequency;
         float seconds_elapsed_total = seconds_elapsed_for_work;
+        last_frame_work_ms = 1000.0f * seconds_elapsed_for_work;
 
         // Busy-wait until we reach target frame time
         while (seconds_elapsed_total < target_seconds_per_frame) {
@@ -918,6 +1200,10 @@ int main() {
                 // Less than 2ms left: busy-wait (tight loop) for maximum precision
             }
 
+            // Keep draining messages while we wait so the window stays responsive
+            // (events are stamped with their OS queue time, not when we read them)
+            platform_update_window(&input);
+
             // Check elapsed time again
             QueryPerformanceCounter(&work_counter_end);
             long long total_elapsed = work_counter_end.QuadPart - work_counter_begin.QuadPart;
@@ -926,7 +1212,15 @@ int main() {
     } 
 
     // Cleanup
+    particles_free(&global_dust);
+    particles_free(&global_sparks);
+    rewind_free(&global_rewind);
+    world_free(&game_world);
+    job_system_shutdown(&global_job_system);
     timeEndPeriod(1); // Restore Windows scheduler to normal resolution
+    std::cout << "Input-to-present latency: avg " << global_input_latency.average_ms
+              << " ms, max " << global_input_latency.max_ms
+              << " ms (" << global_input_latency.event_count << " events)" << std::endl;
     std::cout << "Shutting down strangerEngine." << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "particles.h"
+#include "kernels.h"
+
+#include <math.h>   // Required for sqrtf, cosf, sinf, floorf
+#include <stdlib.h> // Required for malloc, free
+#include <string.h> // Required for memcpy
+
+// Attribute arrays per pool (pos_x, pos_y, vel_x, vel_y, life, inv_lifetime)
+#define PARTICLE_ARRAY_COUNT 6
+
+// ##################################################################
+//                          Pool Setup
+// ##################################################################
+
+bool particles_init(ParticlePool* pool, int sprite_size, uint32_t color, ParticleBlendMode blend_mode) {
+    if (sprite_size < 1) sprite_size = 1;
+
+    // One block for every array, aligned to a cache line (+63 bytes of slack for the alignment)
+    size_t array_size = PARTICLE_MAX_COUNT * sizeof(float);
+    pool->memory = malloc(array_size * PARTICLE_ARRAY_COUNT + 63);
+    if (!pool->memory) return false;
+
+    float* base = (float*)(((uintptr_t)pool->memory + 63) & ~(uintptr_t)63);
+    pool->pos_x = base;
+    pool->pos_y = base + PARTICLE_MAX_COUNT;
+    pool->vel_x = base + 2 * PARTICLE_MAX_COUNT;
+    pool->vel_y = base + 3 * PARTICLE_MAX_COUNT;
+    pool->life = base + 4 * PARTICLE_MAX_COUNT;
+    pool->inv_lifetime = base + 5 * PARTICLE_MAX_COUNT;
+    pool->count = 0;
+    pool->blend_mode = blend_mode;
+
+    // Sprite: a soft disc, one frame per fade step
+    pool->sprite_size = sprite_size;
+    pool->sprite.width = sprite_size * PARTICLE_SPRITE_FRAMES;
+    pool->sprite.height = sprite_size;
+    pool->sprite.pixels = (uint32_t*)malloc((size_t)pool->sprite.width * pool->sprite.height * sizeof(uint32_t));
+    if (!pool->sprite.pixels) {
+        free(pool->memory);
+        pool->memory = 0;
+        return false;
+    }
+
+    float radius = 0.5f * (float)sprite_size;
+    for (int y = 0; y < sprite_size; ++y) {
+        for (int x = 0; x < sprite_size; ++x) {
+            // Distance from the pixel center to the sprite center, 0 at the middle, 1 at the edge
+            float dx = ((float)x + 0.5f - radius) / radius;
+            float dy = ((float)y + 0.5f - radius) / radius;
+            float falloff = 1.0f - sqrtf(dx * dx + dy * dy);
+            if (falloff < 0.0f) falloff = 0.0f;
+            falloff *= falloff;
+
+            for (int frame = 0; frame < PARTICLE_SPRITE_FRAMES; ++frame) {
+                float fade = 1.0f - (float)frame / (float)PARTICLE_SPRITE_FRAMES;
+                float coverage = falloff * fade;
+
+                // Premultiplied, like every bitmap the renderer draws
+                uint32_t alpha = (uint32_t)(255.0f * coverage + 0.5f);
+                uint32_t r = (uint32_t)((float)((color >> 16) & 0xFF) * coverage + 0.5f);
+                uint32_t g = (uint32_t)((float)((color >> 8) & 0xFF) * coverage + 0.5f);
+                uint32_t b = (uint32_t)((float)(color & 0xFF) * coverage + 0.5f);
+                uint32_t* pixel = pool->sprite.pixels + y * pool->sprite.width + frame * sprite_size + x;
+                *pixel = (alpha << 24) | (r << 16) | (g << 8) | b;
+            }
+        }
+    }
+    return true;
+}
+
+void particles_free(ParticlePool* pool) {
+    free(pool->memory);
+    free(pool->sprite.pixels);
+    pool->memory = 0;
+    pool->sprite.pixels = 0;
+    pool->count = 0;
+}
+
+// ##################################################################
+//                          Emission
+// ##################################################################
+
+// xorshift32 -> [0, 1)
+static float random_unit(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return (float)(*state >> 8) * (1.0f / 16777216.0f);
+}
+
+static void spawn_particle(ParticlePool* pool, ParticleEmitter* emitter) {
+    float angle = emitter->angle + emitter->spread * (2.0f * random_unit(&emitter->random_state) - 1.0f);
+    float speed = emitter->speed_min + (emitter->speed_max - emitter->speed_min) * random_unit(&emitter->random_state);
+    float life = emitter->life_min + (emitter->life_max - emitter->life_min) * random_unit(&emitter->random_state);
+    if (life <= 0.0f) life = 0.001f;
+
+    int i = pool->count++;
+    float half_size = 0.5f * (float)pool->sprite_size;
+    pool->pos_x[i] = emitter->x - half_size;
+    pool->pos_y[i] = emitter->y - half_size;
+    pool->vel_x[i] = cosf(angle) * speed;
+    pool->vel_y[i] = sinf(angle) * speed;
+    pool->life[i] = life;
+    pool->inv_lifetime[i] = 1.0f / life;
+}
+
+int particles_burst(ParticlePool* pool, ParticleEmitter* emitter, int count) {
+    int room = PARTICLE_MAX_COUNT - pool->count;
+    if (count > room) count = room;
+
+    for (int i = 0; i < count; ++i) {
+        spawn_particle(pool, emitter);
+    }
+    return count;
+}
+
+void particles_emit(ParticlePool* pool, ParticleEmitter* emitter, float dt) {
+    emitter->accumulator += emitter->rate * dt;
+    int count = (int)emitter->accumulator;
+    emitter->accumulator -= (float)count;
+
+    // A full pool drops the excess (it is not carried over, or it would burst later)
+    particles_burst(pool, emitter, count);
+}
+
+// ##################################################################
+//                          Simulation
+// ##################################################################
+
+void particles_update(ParticlePool* pool, float dt, float gravity) {
+    // Integration of every live particle (best kernel for this CPU)
+    global_kernels.update_particles(pool->pos_x, pool->pos_y, pool->vel_x, pool->vel_y, pool->life,
+                                    pool->count, dt, gravity);
+
+    // Swap-remove: the last live particle takes the place of each dead one
+    int count = pool->count;
+    int i = 0;
+    while (i < count) {
+        if (pool->life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+
+        // The moved particle is checked again on the next iteration (it may be dead too)
+        count--;
+        pool->pos_x[i] = pool->pos_x[count];
+        pool->pos_y[i] = pool->pos_y[count];
+        pool->vel_x[i] = pool->vel_x[count];
+        pool->vel_y[i] = pool->vel_y[count];
+        pool->life[i] = pool->life[count];
+        pool->inv_lifetime[i] = pool->inv_lifetime[count];
+    }
+    pool->count = count;
+}
+
+// ##################################################################
+//                          Save State
+// ##################################################################
+
+// Block layout: for every PARTICLE_STATE_BLOCK particles, each field as a packed run (the last block
+// is shorter). The fields that never change after spawning go first, so two consecutive snapshots
+// of a block share a long run of equal bytes, and the changing fields form one long literal:
+// the delta is a couple of tokens per block instead of one per particle.
+size_t particles_save_state(ParticlePool* pool, uint8_t* dest) {
+    memcpy(dest, &pool->count, sizeof(int));
+    uint8_t* out = dest + sizeof(int);
+    float* fields[6] = { pool->vel_x, pool->inv_lifetime, pool->pos_x, pool->pos_y, pool->vel_y, pool->life };
+
+    for (int first = 0; first < pool->count; first += PARTICLE_STATE_BLOCK) {
+        int block_count = pool->count - first;
+        if (block_count > PARTICLE_STATE_BLOCK) block_count = PARTICLE_STATE_BLOCK;
+        size_t field_bytes = (size_t)block_count * sizeof(float);
+
+        for (int f = 0; f < 6; ++f) {
+            memcpy(out, fields[f] + first, field_bytes);
+            out += field_bytes;
+        }
+    }
+    return sizeof(int) + (size_t)pool->count * PARTICLE_STATE_RECORD_SIZE;
+}
+
+size_t particles_load_state(ParticlePool* pool, const uint8_t* source) {
+    int count;
+    memcpy(&count, source, sizeof(int));
+    if (count < 0) count = 0;
+    if (count > PARTICLE_MAX_COUNT) count = PARTICLE_MAX_COUNT;
+    const uint8_t* in = source + sizeof(int);
+    float* fields[6] = { pool->vel_x, pool->inv_lifetime, pool->pos_x, pool->pos_y, pool->vel_y, pool->life };
+
+    for (int first = 0; first < count; first += PARTICLE_STATE_BLOCK) {
+        int block_count = count - first;
+        if (block_count > PARTICLE_STATE_BLOCK) block_count = PARTICLE_STATE_BLOCK;
+        size_t field_bytes = (size_t)block_count * sizeof(float);
+
+        for (int f = 0; f < 6; ++f) {
+            memcpy(fields[f] + first, in, field_bytes);
+            in += field_bytes;
+        }
+    }
+    pool->count = count;
+    return sizeof(int) + (size_t)count * PARTICLE_STATE_RECORD_SIZE;
+}
+
+// ##################################################################
+//                          Rendering
+// ##################################################################
+
+int particles_render(GameBuffer* buffer, ParticlePool* pool, float camera_x, float camera_y) {
+    int size = pool->sprite_size;
+    float min_x = (float)-size;
+    float min_y = (float)-size;
+    float max_x = (float)buffer->width;
+    float max_y = (float)buffer->height;
+    int drawn = 0;
+
+    for (int i = 0; i < pool->count; ++i) {
+        float x = pool->pos_x[i] - camera_x;
+        float y = pool->pos_y[i] - camera_y;
+
+        // Off screen: skip before paying for the clip + kernel call
+        if (x <= min_x || y <= min_y || x >= max_x || y >= max_y) continue;
+
+        // Fade frame from the fraction of life already spent
+        int frame = (int)((1.0f - pool->life[i] * pool->inv_lifetime[i]) * PARTICLE_SPRITE_FRAMES);
+        if (frame < 0) frame = 0;
+        if (frame >= PARTICLE_SPRITE_FRAMES) frame = PARTICLE_SPRITE_FRAMES - 1;
+
+        // Floor, not truncation: particles partly off the left/top edge must not jump a pixel inwards
+        int screen_x = (int)floorf(x);
+        int screen_y = (int)floorf(y);
+        if (pool->blend_mode == PARTICLE_BLEND_ADDITIVE) {
+            draw_bitmap_additive_region(buffer, &pool->sprite, frame * size, 0, size, size, screen_x, screen_y);
+        } else {
+            draw_bitmap_alpha_region(buffer, &pool->sprite, frame * size, 0, size, size, screen_x, screen_y);
+        }
+        drawn++;
+    }
+    return drawn;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "render.h"
+
+// ##################################################################
+//                          Particle Types
+// ##################################################################
+//
+// Structure-of-arrays pools: each attribute is a separate packed float
+// array so the update kernel streams through them with full-width SIMD
+// loads. Dead particles are swap-removed, so [0, count) is always live.
+
+// Particles per pool (multiple of 16 so every array stays 64-byte aligned)
+#define PARTICLE_MAX_COUNT 131072
+
+// Fade frames per particle sprite (laid out horizontally, most opaque first)
+#define PARTICLE_SPRITE_FRAMES 4
+
+// Saved state: the live count, then the particles in blocks, each field packed within a block
+#define PARTICLE_STATE_BLOCK 64
+#define PARTICLE_STATE_RECORD_SIZE (6 * sizeof(float))     // Bytes per particle
+#define PARTICLE_STATE_MAX_SIZE (sizeof(int) + PARTICLE_MAX_COUNT * PARTICLE_STATE_RECORD_SIZE)
+
+enum ParticleBlendMode {
+    PARTICLE_BLEND_ALPHA,       // Covers what is behind (dust, smoke)
+    PARTICLE_BLEND_ADDITIVE,    // Adds light (sparks, glow)
+};
+
+struct ParticlePool {
+    int count;                  // Live particles
+    float* pos_x;               // Top-left of the sprite, in pixels
+    float* pos_y;
+    float* vel_x;               // Pixels per second
+    float* vel_y;
+    float* life;                // Seconds left (dead at <= 0)
+    float* inv_lifetime;        // 1 / initial life, to pick the fade frame
+
+    LoadedBitmap sprite;        // PARTICLE_SPRITE_FRAMES frames of sprite_size x sprite_size
+    int sprite_size;
+    ParticleBlendMode blend_mode;
+
+    void* memory;               // Single allocation backing all the arrays
+};
+
+// Spawns particles from a point with a random speed/direction inside a cone
+struct ParticleEmitter {
+    float x, y;                 // Spawn point (center of the sprite)
+    float rate;                 // Particles per second (0 = bursts only)
+    float accumulator;          // Fraction of a particle carried to the next frame
+    float angle;                // Cone direction in radians (screen space, -pi/2 = up)
+    float spread;               // Half-angle of the cone in radians
+    float speed_min, speed_max; // Pixels per second
+    float life_min, life_max;   // Seconds
+    uint32_t random_state;      // xorshift32 state (must be non-zero)
+};
+
+// ##################################################################
+//                          Particle Functions
+// ##################################################################
+
+// Allocates the arrays and bakes a soft round sprite (color is RGB, alpha comes from the falloff)
+bool particles_init(ParticlePool* pool, int sprite_size, uint32_t color, ParticleBlendMode blend_mode);
+
+// Frees the pool memory
+void particles_free(ParticlePool* pool);
+
+// Emits rate * dt particles (fractions accumulate across frames)
+void particles_emit(ParticlePool* pool, ParticleEmitter* emitter, float dt);
+
+// Emits count particles at once. Returns how many fit in the pool.
+int particles_burst(ParticlePool* pool, ParticleEmitter* emitter, int count);
+
+// Integrates all live particles under gravity and removes the dead ones
+void particles_update(ParticlePool* pool, float dt, float gravity);
+
+// Writes the live particles to dest (up to PARTICLE_STATE_MAX_SIZE bytes). Returns the bytes written.
+// Fields are packed per block of particles, so a change in the live count only changes the last block.
+size_t particles_save_state(ParticlePool* pool, uint8_t* dest);
+
+// Restores particles written by particles_save_state. Returns the bytes read.
+size_t particles_load_state(ParticlePool* pool, const uint8_t* source);
+
+// Draws every live particle with the pool's blend mode. Positions are in world space:
+// (camera_x, camera_y) is the world point at the top-left of the screen. Returns the number drawn.
+int particles_render(GameBuffer* buffer, ParticlePool* pool, float camera_x, float camera_y);
@@ -0,0 +1,720 @@
+#include "render.h"
+#include "kernels.h"
+#include "kernels_internal.h"
+
+#include <math.h>   // Required for floorf, fabsf, sqrtf
+#include <stdlib.h> // Required for malloc, free
+#include <string.h> // Required for memset
+
+OverdrawState global_overdraw;
+
+// ##################################################################
+//                  Overdraw Instrumentation
+// ##################################################################
+
+// Clears the per-pixel counters and the per-function totals for a new frame
+void overdraw_begin_frame(GameBuffer* buffer) {
+    OverdrawState* overdraw = &global_overdraw;
+    if (!overdraw->enabled) return;
+
+    // (Re)allocate the side buffers when the back buffer changes size
+    if (overdraw->width != buffer->width || overdraw->height != buffer->height) {
+        free(overdraw->write_counts);
+        overdraw->width = buffer->width;
+        overdraw->height = buffer->height;
+        // One allocation: write counts followed by blend counts
+        overdraw->write_counts = (uint8_t*)malloc((size_t)overdraw->width * overdraw->height * 2);
+        if (!overdraw->write_counts) {
+            // No counters: the draw functions must not record anything (F1 can try again)
+            overdraw->enabled = false;
+            overdraw->width = 0;
+            overdraw->height = 0;
+            overdraw->blend_counts = 0;
+            return;
+        }
+        overdraw->blend_counts = overdraw->write_counts + overdraw->width * overdraw->height;
+    }
+
+    memset(overdraw->write_counts, 0, overdraw->width * overdraw->height * 2);
+    memset(overdraw->stats, 0, sizeof(overdraw->stats));
+}
+
+// Area a draw call asked for, before clipping. An empty or negative size requests nothing
+// (it must not turn into a negative, or a wrapped, clipped count)
+static int64_t requested_rect_area(int width, int height) {
+    return (width > 0 && height > 0) ? (int64_t)width * height : 0;
+}
+
+// Records a rectangle of opaque writes (draw_rect, draw_bitmap)
+// The rectangle is the already-clipped one; requested_area is before clipping
+static void overdraw_record_fill(DrawFunction function, int min_x, int min_y, int max_x, int max_y, int64_t requested_area) {
+    OverdrawState* overdraw = &global_overdraw;
+    DrawFunctionStats* stats = &overdraw->stats[function];
+
+    int64_t visible_area = 0;
+    if (max_x > min_x && max_y > min_y) {
+        visible_area = (int64_t)(max_x - min_x) * (max_y - min_y);
+    }
+
+    stats->calls++;
+    stats->pixels_filled += visible_area;
+    stats->pixels_clipped += requested_area - visible_area;
+
+    for (int y = min_y; y < max_y; ++y) {
+        uint8_t* count = overdraw->write_counts + y * overdraw->width + min_x;
+        for (int x = min_x; x < max_x; ++x) {
+            if (*count < 255) (*count)++;
+            count++;
+        }
+    }
+}
+
+// Records an alpha or additive blit, classifying every visible source pixel the same way the kernel does
+// (additive blits read the destination even at alpha 255). requested_area is the source region before clipping
+static void overdraw_record_alpha_blit(DrawFunction function, LoadedBitmap* bitmap,
+                                       int source_offset_x, int source_offset_y,
+                                       int min_x, int min_y, int max_x, int max_y, int64_t requested_area) {
+    OverdrawState* overdraw = &global_overdraw;
+    DrawFunctionStats* stats = &overdraw->stats[function];
+    bool opaque_is_fill = (function == DRAW_FUNCTION_BITMAP_ALPHA);
+
+    int64_t visible_area = 0;
+    if (max_x > min_x && max_y > min_y) {
+        visible_area = (int64_t)(max_x - min_x) * (max_y - min_y);
+    }
+
+    stats->calls++;
+    stats->pixels_clipped += requested_area - visible_area;
+
+    uint32_t* source_row = bitmap->pixels + (source_offset_y * bitmap->width) + source_offset_x;
+    for (int y = min_y; y < max_y; ++y) {
+        uint32_t* source_pixel = source_row;
+        uint8_t* write_count = overdraw->write_counts + y * overdraw->width + min_x;
+        uint8_t* blend_count = overdraw->blend_counts + y * overdraw->width + min_x;
+
+        for (int x = min_x; x < max_x; ++x) {
+            uint8_t alpha = (*source_pixel >> 24) & 0xFF;
+            if (alpha == 0) {
+                stats->pixels_skipped++;
+            } else {
+                if (alpha == 255 && opaque_is_fill) {
+                    stats->pixels_filled++;
+                } else {
+                    stats->pixels_blended++;
+                    if (*blend_count < 255) (*blend_count)++;
+                }
+                if (*write_count < 255) (*write_count)++;
+            }
+            source_pixel++;
+            write_count++;
+            blend_count++;
+        }
+        source_row += bitmap->width;
+    }
+}
+
+// Premultiplied white at ~38% alpha, blended over the heat color of pixels that were blended
+#define OVERDRAW_BLEND_TINT 0x60606060
+
+static const char* draw_function_names[DRAW_FUNCTION_COUNT] = {
+    "draw_rect", "draw_bitmap", "draw_bitmap_alpha", "draw_bitmap_additive",
+    "draw_triangle", "draw_line"
+};
+
+const char* draw_function_name(DrawFunction function) {
+    return draw_function_names[function];
+}
+
+// Maps a write count to a heatmap color: 0 blue, 1 green, 2 yellow, 3 orange, 4+ red
+static uint32_t overdraw_heat_color(uint8_t writes) {
+    static const uint32_t heat_colors[] = {
+        0xFF000080, // Never written
+        0xFF00C000, // Written once (ideal)
+        0xFFE0E000,
+        0xFFFF8000,
+        0xFFFF0000, // 4 or more
+    };
+    if (writes > 4) writes = 4;
+    return heat_colors[writes];
+}
+
+// Blends the heatmap over the frame (the totals are shown by the stats overlay)
+// Called after all drawing, so the overlay itself is not counted
+void overdraw_end_frame(GameBuffer* buffer) {
+    OverdrawState* overdraw = &global_overdraw;
+    if (!overdraw->enabled) return;
+
+    uint8_t* row = (uint8_t*)buffer->memory;
+    for (int y = 0; y < buffer->height; ++y) {
+        uint32_t* pixel = (uint32_t*)row;
+        uint8_t* write_count = overdraw->write_counts + y * overdraw->width;
+        uint8_t* blend_count = overdraw->blend_counts + y * overdraw->width;
+
+        for (int x = 0; x < buffer->width; ++x) {
+            uint32_t heat = overdraw_heat_color(*write_count);
+
+            // Pixels that were blended are lightened toward white so blend cost stands out
+            if (*blend_count > 0) heat = blend_pixel(OVERDRAW_BLEND_TINT, heat);
+
+            // 50% mix with the scene so the geometry is still recognizable
+            *pixel = 0xFF000000 | (((*pixel & 0xFEFEFE) >> 1) + ((heat & 0xFEFEFE) >> 1));
+
+            pixel++;
+            write_count++;
+            blend_count++;
+        }
+        row += buffer->pitch;
+    }
+}
+
+// ##################################################################
+//                          Software Renderer
+// ##################################################################
+
+// Draws a solid filled rectangle to the back buffer
+// Parameters: buffer (target), x/y (position), width/height (size), color (ARGB)
+void draw_rect(GameBuffer* buffer, int x, int y, int width, int height, uint32_t color) {
+    int min_x = x;
+    int min_y = y;
+    int max_x = x + width;
+    int max_y = y + height;
+
+    // Clipping: ensure rectangle stays within screen bounds
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x > buffer->width) max_x = buffer->width;
+    if (max_y > buffer->height) max_y = buffer->height;
+
+    if (global_overdraw.enabled) {
+        overdraw_record_fill(DRAW_FUNCTION_RECT, min_x, min_y, max_x, max_y, requested_rect_area(width, height));
+    }
+
+    if (max_x <= min_x || max_y <= min_y) return; // Fully clipped
+
+    // Pointer to the start of the rectangle in the back buffer
+    uint8_t* row = (uint8_t*)buffer->memory;
+    row += min_y * buffer->pitch + min_x * 4;
+
+    // Fill each scanline of the rectangle (best kernel for this CPU)
+    global_kernels.fill_pixels(row, buffer->pitch, max_x - min_x, max_y - min_y, color);
+}
+
+// Draws a bitmap/sprite to the back buffer at the specified position
+// Supports clipping at screen edges
+void draw_bitmap(GameBuffer* buffer, LoadedBitmap* bitmap, int x, int y){
+    int min_x = x;
+    int min_y = y;
+    int max_x = x + bitmap->width;
+    int max_y = y + bitmap->height;
+
+    // Clipping calculation
+    // When we clip the draw area, we also need to know where to start
+    // reading from the source texture
+    int source_offset_x = 0;
+    int source_offset_y = 0;
+
+    if (min_x < 0) {
+        source_offset_x = -min_x; // Start further into the texture
+        min_x = 0;
+    }
+    if (min_y < 0) {
+        source_offset_y = -min_y;
+        min_y = 0;
+    }
+    if (max_x > buffer->width) max_x = buffer->width;
+    if (max_y > buffer->height) max_y = buffer->height;
+
+    if (global_overdraw.enabled) {
+        overdraw_record_fill(DRAW_FUNCTION_BITMAP, min_x, min_y, max_x, max_y, (int64_t)bitmap->width * bitmap->height);
+    }
+
+    if (max_x <= min_x || max_y <= min_y) return; // Fully clipped
+
+    // Calculate initial pointers
+    // Destination (screen):
+    uint8_t* dest_row = (uint8_t*)buffer->memory + (min_y * buffer->pitch) + (min_x * 4);
+
+    // Source (texture):
+    // The texture is linear and compact (pitch = width * 4)
+    uint32_t* source_row = bitmap->pixels + (source_offset_y * bitmap->width) + source_offset_x;
+    
+    // Copy each scanline (simple copy, no transparency blending)
+    global_kernels.copy_pixels(dest_row, buffer->pitch, source_row, bitmap->width, max_x - min_x, max_y - min_y);
+}
+
+void draw_bitmap_alpha(GameBuffer* buffer, LoadedBitmap* bitmap, float x, float y){
+    draw_bitmap_alpha_region(buffer, bitmap, 0, 0, bitmap->width, bitmap->height, (int)x, (int)y);
+}
+
+void draw_bitmap_alpha_region(GameBuffer* buffer, LoadedBitmap* bitmap,
+                              int source_x, int source_y, int width, int height, int x, int y) {
+    int min_x = x;
+    int min_y = y;
+    int max_x = min_x + width;
+    int max_y = min_y + height;
+
+
+    // Clipping calculation
+    int source_offset_x = source_x;
+    int source_offset_y = source_y;
+
+    if(min_x < 0 ) { source_offset_x -= min_x; min_x = 0; }
+    if(min_y < 0 ) { source_offset_y -= min_y; min_y = 0; }
+    if(max_x > buffer->width )  max_x = buffer->width;
+    if(max_y > buffer->height ) max_y = buffer->height;
+
+    if (global_overdraw.enabled) {
+        overdraw_record_alpha_blit(DRAW_FUNCTION_BITMAP_ALPHA, bitmap, source_offset_x, source_offset_y,
+                                   min_x, min_y, max_x, max_y, requested_rect_area(width, height));
+    }
+
+    if (max_x <= min_x || max_y <= min_y) return; // Fully clipped
+
+    uint8_t* dest_row = (uint8_t*)buffer->memory + (min_y * buffer->pitch) + (min_x * 4);
+    uint32_t* source_row = bitmap->pixels + (source_offset_y * bitmap->width) + source_offset_x;
+
+    // alpha 0: skip, alpha 255: copy, otherwise blend (rounded integer math, same on every ISA)
+    global_kernels.blend_pixels(dest_row, buffer->pitch, source_row, bitmap->width, max_x - min_x, max_y - min_y);
+}
+
+void draw_bitmap_additive_region(GameBuffer* buffer, LoadedBitmap* bitmap,
+                                 int source_x, int source_y, int width, int height, int x, int y) {
+    int min_x = x;
+    int min_y = y;
+    int max_x = min_x + width;
+    int max_y = min_y + height;
+
+    // Clipping calculation (same as draw_bitmap_alpha_region)
+    int source_offset_x = source_x;
+    int source_offset_y = source_y;
+
+    if(min_x < 0 ) { source_offset_x -= min_x; min_x = 0; }
+    if(min_y < 0 ) { source_offset_y -= min_y; min_y = 0; }
+    if(max_x > buffer->width )  max_x = buffer->width;
+    if(max_y > buffer->height ) max_y = buffer->height;
+
+    if (global_overdraw.enabled) {
+        overdraw_record_alpha_blit(DRAW_FUNCTION_BITMAP_ADDITIVE, bitmap, source_offset_x, source_offset_y,
+                                   min_x, min_y, max_x, max_y, requested_rect_area(width, height));
+    }
+
+    if (max_x <= min_x || max_y <= min_y) return; // Fully clipped
+
+    uint8_t* dest_row = (uint8_t*)buffer->memory + (min_y * buffer->pitch) + (min_x * 4);
+    uint32_t* source_row = bitmap->pixels + (source_offset_y * bitmap->width) + source_offset_x;
+
+    // dest += source (already weighted by its alpha), saturated per channel
+    global_kernels.add_pixels(dest_row, buffer->pitch, source_row, bitmap->width, max_x - min_x, max_y - min_y);
+}
+
+// ##################################################################
+//                          Triangle Rasterizer
+// ##################################################################
+//
+// Half-space rasterizer: a pixel is inside when its center is on the inner
+// side of all three edges, E(x, y) = A*x + B*y + C >= 0 for each edge. E is
+// linear, so it is stepped with additions (A per pixel right, B per pixel
+// down), and its min/max over a block are at the block corners. The screen
+// is walked in RASTER_BLOCK_SIZE blocks: blocks outside one edge are
+// skipped, runs of blocks inside all three are filled as rectangles, and only
+// the blocks an edge crosses are tested per pixel, in SIMD groups.
+//
+// Vertices are snapped to RASTER_SUBPIXEL_BITS fixed point, so the edge
+// values are exact integers and neighboring triangles agree on every pixel.
+
+#define RASTER_SUBPIXEL_ONE (1 << RASTER_SUBPIXEL_BITS)
+
+struct RasterEdge {
+    int64_t a;      // Change of E per subpixel step in x
+    int64_t b;      // Change of E per subpixel step in y
+    int64_t c;      // E at the origin (top-left rule bias included)
+};
+
+// Edge from p to q, inner side on the right of p->q in screen space (y down)
+static RasterEdge make_raster_edge(int32_t px, int32_t py, int32_t qx, int32_t qy) {
+    RasterEdge edge;
+    edge.a = (int64_t)py - qy;
+    edge.b = (int64_t)qx - px;
+    edge.c = -(edge.a * px + edge.b * py);
+
+    // Top-left rule: centers exactly on a left edge (interior to the right, a > 0) or on a top edge
+    // (horizontal, interior below, b > 0) are inside; on any other edge they belong to the neighbor
+    bool top_left = edge.a > 0 || (edge.a == 0 && edge.b > 0);
+    if (!top_left) edge.c -= 1;
+    return edge;
+}
+
+static int32_t snap_to_subpixel(float value) {
+    return (int32_t)floorf(value * (float)RASTER_SUBPIXEL_ONE + 0.5f);
+}
+
+static bool inside_guard_band(float value) {
+    // Written so that NaN fails too
+    return value >= -RASTER_GUARD_BAND && value <= RASTER_GUARD_BAND;
+}
+
+// Counts the pixels of a partially covered block, for the overdraw instrumentation (same test as the kernels)
+static int64_t overdraw_record_edges(int min_x, int min_y, int width, int height, const RasterEdges* edges) {
+    OverdrawState* overdraw = &global_overdraw;
+    int64_t covered = 0;
+
+    for (int y = 0; y < height; ++y) {
+        uint8_t* count = overdraw->write_counts + (min_y + y) * overdraw->width + min_x;
+        for (int x = 0; x < width; ++x) {
+            int32_t e0 = edges->origin[0] + x * edges->step_x[0] + y * edges->step_y[0];
+            int32_t e1 = edges->origin[1] + x * edges->step_x[1] + y * edges->step_y[1];
+            int32_t e2 = edges->origin[2] + x * edges->step_x[2] + y * edges->step_y[2];
+            if ((e0 | e1 | e2) >= 0) {
+                if (count[x] < 255) count[x]++;
+                covered++;
+            }
+        }
+    }
+    return covered;
+}
+
+// Fills a run of fully covered blocks. Returns the pixels written when the overdraw instrumentation is on
+static int64_t raster_fill_span(GameBuffer* buffer, int min_x, int min_y, int width, int height, uint32_t color) {
+    uint8_t* dest_row = (uint8_t*)buffer->memory + min_y * buffer->pitch + min_x * 4;
+    global_kernels.fill_pixels(dest_row, buffer->pitch, width, height, color);
+    if (!global_overdraw.enabled) return 0;
+
+    OverdrawState* overdraw = &global_overdraw;
+    for (int y = min_y; y < min_y + height; ++y) {
+        uint8_t* count = overdraw->write_counts + y * overdraw->width + min_x;
+        for (int x = 0; x < width; ++x) {
+            if (count[x] < 255) count[x]++;
+        }
+    }
+    return (int64_t)width * height;
+}
+
+// Rasterizes one triangle. Returns the pixels written when the overdraw instrumentation is on (0 otherwise)
+static int64_t rasterize_triangle(GameBuffer* buffer, float x0, float y0, float x1, float y1, float x2, float y2,
+                                  uint32_t color) {
+    if (!inside_guard_band(x0) || !inside_guard_band(y0) || !inside_guard_band(x1) ||
+        !inside_guard_band(y1) || !inside_guard_band(x2) || !inside_guard_band(y2)) {
+        return 0;
+    }
+
+    int32_t vx[3] = { snap_to_subpixel(x0), snap_to_subpixel(x1), snap_to_subpixel(x2) };
+    int32_t vy[3] = { snap_to_subpixel(y0), snap_to_subpixel(y1), snap_to_subpixel(y2) };
+
+    // Twice the signed area: positive when the vertices run clockwise on screen
+    int64_t area2 = ((int64_t)vx[1] - vx[0]) * ((int64_t)vy[2] - vy[0]) -
+                    ((int64_t)vy[1] - vy[0]) * ((int64_t)vx[2] - vx[0]);
+    if (area2 == 0) return 0; // Degenerate: covers no pixel center
+    if (area2 < 0) {
+        int32_t t;
+        t = vx[1]; vx[1] = vx[2]; vx[2] = t;
+        t = vy[1]; vy[1] = vy[2]; vy[2] = t;
+    }
+
+    // Bounding box in pixels (max exclusive): pixel x has its center at x * ONE + ONE / 2
+    int32_t box_min_x = vx[0], box_max_x = vx[0], box_min_y = vy[0], box_max_y = vy[0];
+    for (int i = 1; i < 3; ++i) {
+        if (vx[i] < box_min_x) box_min_x = vx[i];
+        if (vx[i] > box_max_x) box_max_x = vx[i];
+        if (vy[i] < box_min_y) box_min_y = vy[i];
+        if (vy[i] > box_max_y) box_max_y = vy[i];
+    }
+    const int32_t half = RASTER_SUBPIXEL_ONE / 2;
+    int min_x = (box_min_x - half + RASTER_SUBPIXEL_ONE - 1) >> RASTER_SUBPIXEL_BITS;
+    int min_y = (box_min_y - half + RASTER_SUBPIXEL_ONE - 1) >> RASTER_SUBPIXEL_BITS;
+    int max_x = ((box_max_x - half) >> RASTER_SUBPIXEL_BITS) + 1;
+    int max_y = ((box_max_y - half) >> RASTER_SUBPIXEL_BITS) + 1;
+
+    // Clipping: same screen bounds as the other draw functions
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x > buffer->width) max_x = buffer->width;
+    if (max_y > buffer->height) max_y = buffer->height;
+    if (max_x <= min_x || max_y <= min_y) return 0; // Fully clipped
+
+    RasterEdge edges[3] = {
+        make_raster_edge(vx[0], vy[0], vx[1], vy[1]),
+        make_raster_edge(vx[1], vy[1], vx[2], vy[2]),
+        make_raster_edge(vx[2], vy[2], vx[0], vy[0]),
+    };
+
+    // Blocks are aligned to the screen grid, so a mesh reuses the same blocks from triangle to triangle
+    const int block = RASTER_BLOCK_SIZE;
+    int block_min_x = min_x & ~(block - 1);
+    int block_min_y = min_y & ~(block - 1);
+
+    // Per-pixel steps, and E at the center of the first block's top-left pixel
+    int64_t step_x[3], step_y[3], row_start[3];
+    for (int k = 0; k < 3; ++k) {
+        step_x[k] = edges[k].a * RASTER_SUBPIXEL_ONE;
+        step_y[k] = edges[k].b * RASTER_SUBPIXEL_ONE;
+        row_start[k] = edges[k].a * ((int64_t)block_min_x * RASTER_SUBPIXEL_ONE + half) +
+                       edges[k].b * ((int64_t)block_min_y * RASTER_SUBPIXEL_ONE + half) + edges[k].c;
+    }
+
+    bool record = global_overdraw.enabled;
+    int64_t written = 0;
+
+    for (int block_y = block_min_y; block_y < max_y; block_y += block) {
+        int y_lo = block_y > min_y ? block_y : min_y;
+        int y_hi = block_y + block < max_y ? block_y + block : max_y;
+        int height = y_hi - y_lo;
+
+        int64_t block_start[3] = { row_start[0], row_start[1], row_start[2] };
+
+        // Run of trivially accepted blocks in this block row, filled with one call when it ends
+        int accepted_x = -1;
+
+        for (int block_x = block_min_x; block_x < max_x; block_x += block) {
+            int x_lo = block_x > min_x ? block_x : min_x;
+            int x_hi = block_x + block < max_x ? block_x + block : max_x;
+            int width = x_hi - x_lo;
+
+            // Classify the block (the part of it inside the bounding box) against each edge
+            RasterEdges crossing;
+            bool rejected = false;
+            int inside_count = 0;
+            for (int k = 0; k < 3; ++k) {
+                int64_t origin = block_start[k] + step_x[k] * (x_lo - block_x) + step_y[k] * (y_lo - block_y);
+                int64_t span_x = step_x[k] * (width - 1);
+                int64_t span_y = step_y[k] * (height - 1);
+                int64_t e_min = origin + (span_x < 0 ? span_x : 0) + (span_y < 0 ? span_y : 0);
+                int64_t e_max = origin + (span_x > 0 ? span_x : 0) + (span_y > 0 ? span_y : 0);
+
+                if (e_max < 0) {
+                    rejected = true;
+                    break;
+                }
+                if (e_min >= 0) {
+                    // Passes everywhere in the block: a zero edge never fails the test
+                    crossing.origin[k] = 0;
+                    crossing.step_x[k] = 0;
+                    crossing.step_y[k] = 0;
+                    inside_count++;
+                } else {
+                    // The edge crosses the block, so |E| <= its span here (~2^28): fits 32 bits
+                    crossing.origin[k] = (int32_t)origin;
+                    crossing.step_x[k] = (int32_t)step_x[k];
+                    crossing.step_y[k] = (int32_t)step_y[k];
+                }
+            }
+
+            if (!rejected && inside_count == 3) {
+                // Trivial accept: joins the run, filled like a rectangle
+                if (accepted_x < 0) accepted_x = x_lo;
+            } else {
+                if (accepted_x >= 0) {
+                    written += raster_fill_span(buffer, accepted_x, y_lo, x_lo - accepted_x, height, color);
+                    accepted_x = -1;
+                }
+                if (!rejected) {
+                    // Partial block: per-pixel edge test (best kernel for this CPU)
+                    uint8_t* dest_row = (uint8_t*)buffer->memory + y_lo * buffer->pitch + x_lo * 4;
+                    global_kernels.fill_edges(dest_row, buffer->pitch, width, height, &crossing, color);
+                    if (record) written += overdraw_record_edges(x_lo, y_lo, width, height, &crossing);
+                }
+            }
+
+            for (int k = 0; k < 3; ++k) block_start[k] += step_x[k] * block;
+        }
+        if (accepted_x >= 0) {
+            written += raster_fill_span(buffer, accepted_x, y_lo, max_x - accepted_x, height, color);
+        }
+
+        for (int k = 0; k < 3; ++k) row_start[k] += step_y[k] * block;
+    }
+    return written;
+}
+
+// Guard-band clipping: vertices further than RASTER_GUARD_BAND from the origin would overflow the
+// fixed-point edge math, so such triangles are cut to the guard-band box (Sutherland-Hodgman) and
+// drawn as a fan. The cut is far outside the screen, so it never shows, and the fan's inner edges
+// follow the top-left rule like any shared edge.
+#define RASTER_CLIP_MAX_VERTICES 7
+
+// Keeps the part of a convex polygon on the inner side of one box side (sign * coordinate <= limit).
+// The new vertex on a crossing edge is computed from its inside end, so the two triangles sharing
+// that edge get exactly the same point. Returns the new vertex count.
+static int clip_polygon_side(const double* in_x, const double* in_y, int count, double* out_x, double* out_y,
+                             bool vertical, double sign) {
+    const double limit = RASTER_GUARD_BAND;
+    int out_count = 0;
+
+    for (int i = 0; i < count; ++i) {
+        int j = (i + 1) % count;
+        double vi = sign * (vertical ? in_y[i] : in_x[i]);
+        double vj = sign * (vertical ? in_y[j] : in_x[j]);
+        bool inside_i = vi <= limit;
+        bool inside_j = vj <= limit;
+
+        if (inside_i) {
+            out_x[out_count] = in_x[i];
+            out_y[out_count] = in_y[i];
+            out_count++;
+        }
+        if (inside_i != inside_j) {
+            int a = inside_i ? i : j;   // Inside end
+            int b = inside_i ? j : i;
+            double va = inside_i ? vi : vj;
+            double vb = inside_i ? vj : vi;
+            double t = (limit - va) / (vb - va);
+            out_x[out_count] = in_x[a] + t * (in_x[b] - in_x[a]);
+            out_y[out_count] = in_y[a] + t * (in_y[b] - in_y[a]);
+            if (vertical) out_y[out_count] = sign * limit; else out_x[out_count] = sign * limit;
+            out_count++;
+        }
+    }
+    return out_count;
+}
+
+// Rasterizes a triangle of any size: cut to the guard band when a vertex lies outside it.
+// Only triangles entirely outside the guard band (or with non-finite vertices) draw nothing.
+static int64_t rasterize_clipped_triangle(GameBuffer* buffer, float x0, float y0, float x1, float y1,
+                                          float x2, float y2, uint32_t color) {
+    float coordinates[6] = { x0, y0, x1, y1, x2, y2 };
+    bool inside = true;
+    for (int i = 0; i < 6; ++i) {
+        if (!(fabsf(coordinates[i]) <= 3.0e38f)) return 0;     // NaN or infinity
+        if (!inside_guard_band(coordinates[i])) inside = false;
+    }
+    if (inside) return rasterize_triangle(buffer, x0, y0, x1, y1, x2, y2, color);
+
+    double poly_x[2][RASTER_CLIP_MAX_VERTICES] = { { x0, x1, x2 } };
+    double poly_y[2][RASTER_CLIP_MAX_VERTICES] = { { y0, y1, y2 } };
+    int count = 3;
+    int current = 0;
+    static const bool sides_vertical[4] = { false, false, true, true };
+    static const double sides_sign[4] = { 1.0, -1.0, 1.0, -1.0 };
+    for (int side = 0; side < 4 && count > 0; ++side) {
+        count = clip_polygon_side(poly_x[current], poly_y[current], count, poly_x[1 - current], poly_y[1 - current],
+                                  sides_vertical[side], sides_sign[side]);
+        current = 1 - current;
+    }
+
+    int64_t written = 0;
+    const double* px = poly_x[current];
+    const double* py = poly_y[current];
+    for (int i = 1; i + 1 < count; ++i) {
+        written += rasterize_triangle(buffer, (float)px[0], (float)py[0], (float)px[i], (float)py[i],
+                                      (float)px[i + 1], (float)py[i + 1], color);
+    }
+    return written;
+}
+
+// Adds the totals of one triangle/line call. requested_area is the covered area before clipping
+static void overdraw_record_raster(DrawFunction function, int64_t written, float requested_area) {
+    DrawFunctionStats* stats = &global_overdraw.stats[function];
+    int64_t requested = (int64_t)(requested_area + 0.5f);
+
+    stats->calls++;
+    stats->pixels_filled += written;
+    if (requested > written) stats->pixels_clipped += requested - written;
+}
+
+void draw_triangle(GameBuffer* buffer, float x0, float y0, float x1, float y1, float x2, float y2, uint32_t color) {
+    int64_t written = rasterize_clipped_triangle(buffer, x0, y0, x1, y1, x2, y2, color);
+
+    if (global_overdraw.enabled) {
+        float area = 0.5f * fabsf((x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0));
+        overdraw_record_raster(DRAW_FUNCTION_TRIANGLE, written, area);
+    }
+}
+
+// Cuts the segment to the rectangle [min_x, max_x] x [min_y, max_y] (Liang-Barsky).
+// Returns false when nothing is left
+static bool clip_segment(float* x0, float* y0, float* x1, float* y1,
+                         float min_x, float min_y, float max_x, float max_y) {
+    float dx = *x1 - *x0;
+    float dy = *y1 - *y0;
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+
+    // For each side: p = movement towards the outside per unit of t, q = distance to the side
+    float p[4] = { -dx, dx, -dy, dy };
+    float q[4] = { *x0 - min_x, max_x - *x0, *y0 - min_y, max_y - *y0 };
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f) return false; // Parallel to this side and outside it
+            continue;
+        }
+        float t = q[i] / p[i];
+        if (p[i] < 0.0f) {
+            if (t > t1) return false;
+            if (t > t0) t0 = t;
+        } else {
+            if (t < t0) return false;
+            if (t < t1) t1 = t;
+        }
+    }
+
+    float start_x = *x0, start_y = *y0;
+    *x0 = start_x + t0 * dx;
+    *y0 = start_y + t0 * dy;
+    *x1 = start_x + t1 * dx;
+    *y1 = start_y + t1 * dy;
+    return true;
+}
+
+void draw_line(GameBuffer* buffer, float x0, float y0, float x1, float y1, float thickness, uint32_t color) {
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float length = sqrtf(dx * dx + dy * dy);
+    int64_t written = 0;
+
+    if (length > 0.0f && thickness > 0.0f) {
+        // Only the part of the segment within half a thickness of the screen can reach a pixel,
+        // and cutting it there keeps long lines inside the guard band (very thick ones can still
+        // leave it: their triangles are cut like any other)
+        float margin = 0.5f * thickness + 1.0f;
+        if (clip_segment(&x0, &y0, &x1, &y1, -margin, -margin,
+                         (float)buffer->width + margin, (float)buffer->height + margin)) {
+            // Half-thickness offset along the normal (direction of the original segment)
+            float scale = 0.5f * thickness / length;
+            float nx = -dy * scale;
+            float ny = dx * scale;
+
+            // Two triangles sharing the a-c diagonal: the top-left rule writes its pixels once
+            float ax = x0 + nx, ay = y0 + ny;
+            float bx = x1 + nx, by = y1 + ny;
+            float cx = x1 - nx, cy = y1 - ny;
+            float ex = x0 - nx, ey = y0 - ny;
+            written += rasterize_clipped_triangle(buffer, ax, ay, bx, by, cx, cy, color);
+            written += rasterize_clipped_triangle(buffer, ax, ay, cx, cy, ex, ey, color);
+        }
+    }
+
+    if (global_overdraw.enabled) {
+        overdraw_record_raster(DRAW_FUNCTION_LINE, written, length * thickness);
+    }
+}
+
+// ##################################################################
+//                          Test Assets
+// ##################################################################
+
+LoadedBitmap make_test_bitmap(int width, int height) {
+    LoadedBitmap bmp = {};
+    bmp.width = width;
+    bmp.height = height;
+    
+    // Allocate memory for pixel data (4 bytes per pixel for ARGB)
+    size_t size = (size_t)width * height * 4;
+    bmp.pixels = (uint32_t*)malloc(size);
+    if (!bmp.pixels) return bmp;
+
+    // Fill pixels with checkerboard pattern
+    uint32_t* pixel_ptr = bmp.pixels;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            // Checkerboard: divide by 8 and check if sum is even/odd
+            bool black = ((x / 8) + (y / 8)) % 2 == 0;
+            
+            if (black) {
+                *pixel_ptr = 0xFF000000; // Black
+            } else {
+                *pixel_ptr = 0xFFFF00FF; // Bright magenta
+            }
+            pixel_ptr++;
+        }
+    }
+    return bmp;
+}
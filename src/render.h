@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+
+// ##################################################################
+//                          Render Types
+// ##################################################################
+
+// Represents the game's back buffer (framebuffer)
+// Contains the pixel data and dimensions for drawing
+struct GameBuffer {
+    void* memory;       // Pointer to pixel data
+    int width;          // Screen width in pixels
+    int height;         // Screen height in pixels
+    int pitch;          // Bytes per scanline (width * 4 for 32-bit)
+};
+
+// Represents a loaded bitmap/image in memory
+struct LoadedBitmap {
+    int width;          // Image width in pixels
+    int height;         // Image height in pixels
+    uint32_t* pixels;   // Pointer to pixel color data (premultiplied ARGB, top-down)
+};
+
+// Triangle vertices are snapped to 1/16 pixel (4 subpixel bits)
+#define RASTER_SUBPIXEL_BITS 4
+
+// Largest vertex coordinate the fixed-point edge math takes, in pixels. Triangles reaching further are
+// cut to this box before snapping (far outside the screen, so the cut never shows)
+#define RASTER_GUARD_BAND 16384.0f
+
+// Draw functions tracked by the overdraw instrumentation
+enum DrawFunction {
+    DRAW_FUNCTION_RECT,
+    DRAW_FUNCTION_BITMAP,
+    DRAW_FUNCTION_BITMAP_ALPHA,
+    DRAW_FUNCTION_BITMAP_ADDITIVE,
+    DRAW_FUNCTION_TRIANGLE,
+    DRAW_FUNCTION_LINE,
+    DRAW_FUNCTION_COUNT
+};
+
+// Per-frame fill-rate totals for one draw function
+struct DrawFunctionStats {
+    uint32_t calls;             // Times the function was called
+    uint64_t pixels_filled;     // Pixels overwritten with an opaque color
+    uint64_t pixels_blended;    // Pixels read, blended and written back
+    uint64_t pixels_skipped;    // Pixels visited but left untouched (alpha == 0)
+    uint64_t pixels_clipped;    // Pixels requested outside the screen
+};
+
+// Optional instrumentation that counts how many times each pixel is written per frame
+struct OverdrawState {
+    bool enabled;               // Instrumentation + heatmap active
+    int width;                  // Dimensions of the side buffers
+    int height;
+    uint8_t* write_counts;      // Writes (fills + blends) per pixel, saturating at 255
+    uint8_t* blend_counts;      // Blends per pixel, saturating at 255
+    DrawFunctionStats stats[DRAW_FUNCTION_COUNT];
+};
+
+// Overdraw/fill-rate instrumentation (toggled with F1)
+extern OverdrawState global_overdraw;
+
+// ##################################################################
+//                          Render Functions
+// ##################################################################
+
+// Draws a solid filled rectangle to the back buffer
+void draw_rect(GameBuffer* buffer, int x, int y, int width, int height, uint32_t color);
+
+// Copies a bitmap to the back buffer (no transparency), clipped at screen edges
+void draw_bitmap(GameBuffer* buffer, LoadedBitmap* bitmap, int x, int y);
+
+// Alpha-blends a bitmap over the back buffer, clipped at screen edges
+void draw_bitmap_alpha(GameBuffer* buffer, LoadedBitmap* bitmap, float x, float y);
+
+// Alpha-blends the width x height region of a bitmap starting at (source_x, source_y)
+// Same clipping as draw_bitmap_alpha (used for atlases: glyphs, sprite sheets)
+void draw_bitmap_alpha_region(GameBuffer* buffer, LoadedBitmap* bitmap,
+                              int source_x, int source_y, int width, int height, int x, int y);
+
+// Adds the (premultiplied) colors of the width x height region of a bitmap to the back buffer
+// (glow/spark sprites: overlapping sprites get brighter instead of covering each other)
+void draw_bitmap_additive_region(GameBuffer* buffer, LoadedBitmap* bitmap,
+                                 int source_x, int source_y, int width, int height, int x, int y);
+
+// Fills a triangle (any winding) with a solid color. Vertices are in pixels: pixel (x, y) is covered
+// when its center (x + 0.5, y + 0.5) is inside. Pixel centers on a shared edge belong to exactly one
+// of the two triangles (top-left rule), so meshes draw every pixel once. Clipped at screen edges
+// (vertices may lie anywhere; non-finite vertices draw nothing).
+void draw_triangle(GameBuffer* buffer, float x0, float y0, float x1, float y1, float x2, float y2, uint32_t color);
+
+// Fills the thickness-wide rectangle around the segment (x0, y0)-(x1, y1), flat ends, solid color.
+// Same coverage rules as draw_triangle (drawn as two triangles); clipped at screen edges
+void draw_line(GameBuffer* buffer, float x0, float y0, float x1, float y1, float thickness, uint32_t color);
+
+// Creates a procedural test bitmap (checkerboard pattern), allocated with malloc
+// Useful as a fallback when image files fail to load
+LoadedBitmap make_test_bitmap(int width, int height);
+
+// Clears the overdraw counters for a new frame (no-op when disabled)
+void overdraw_begin_frame(GameBuffer* buffer);
+
+// Blends the overdraw heatmap over the frame (no-op when disabled)
+void overdraw_end_frame(GameBuffer* buffer);
+
+// Name of a draw function, for the overdraw totals ("draw_rect", ...)
+const char* draw_function_name(DrawFunction function);
@@ -0,0 +1,303 @@
+#include "rewind.h"
+
+#include <stdlib.h> // Required for malloc, calloc, free
+#include <string.h> // Required for memcpy, memset
+
+// ##################################################################
+//                          Setup
+// ##################################################################
+
+bool rewind_init(RewindBuffer* rewind, size_t ring_size, int max_entries, size_t max_image_size) {
+    memset(rewind, 0, sizeof(*rewind));
+    rewind->ring_size = ring_size;
+    rewind->max_entries = max_entries;
+    rewind->max_image_size = max_image_size;
+
+    rewind->ring = (uint8_t*)malloc(ring_size);
+    rewind->entries = (RewindEntry*)malloc((size_t)max_entries * sizeof(RewindEntry));
+    rewind->scratch = (uint8_t*)malloc(REWIND_MAX_DELTA_SIZE(max_image_size));
+
+    // Zeroed: bytes past the size of an image must read as zero
+    rewind->current = (uint8_t*)calloc(max_image_size, 1);
+    rewind->next = (uint8_t*)calloc(max_image_size, 1);
+
+    if (!rewind->ring || !rewind->entries || !rewind->scratch || !rewind->current || !rewind->next) {
+        rewind_free(rewind);
+        return false;
+    }
+    return true;
+}
+
+void rewind_free(RewindBuffer* rewind) {
+    free(rewind->ring);
+    free(rewind->entries);
+    free(rewind->scratch);
+    free(rewind->current);
+    free(rewind->next);
+    memset(rewind, 0, sizeof(*rewind));
+}
+
+void rewind_clear(RewindBuffer* rewind) {
+    rewind->ring_head = 0;
+    rewind->entry_first = 0;
+    rewind->entry_count = 0;
+    rewind->history_bytes = 0;
+    rewind->history_image_bytes = 0;
+    rewind->history_seconds = 0.0f;
+
+    // The current image stays: it is still the state of the game
+}
+
+// ##################################################################
+//                          Delta Encoding
+// ##################################################################
+
+static uint8_t* write_varint(uint8_t* out, size_t value) {
+    while (value >= 0x80) {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+static const uint8_t* read_varint(const uint8_t* in, size_t* value) {
+    size_t result = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = *in++;
+        result |= (size_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    *value = result;
+    return in;
+}
+
+static uint64_t load_u64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Byte index (little-endian) of the lowest / highest set byte of a non-zero mask
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+static int lowest_bit(uint64_t x) { unsigned long bit; _BitScanForward64(&bit, x); return (int)bit; }
+static int highest_bit(uint32_t x) { unsigned long bit; _BitScanReverse(&bit, x); return (int)bit; }
+#else
+static int lowest_bit(uint64_t x) { return __builtin_ctzll(x); }
+static int highest_bit(uint32_t x) { return 31 - __builtin_clz(x); }
+#endif
+
+// One bit per byte of x (bit k = byte k), set where the byte is zero
+static uint32_t zero_byte_mask(uint64_t x) {
+    const uint64_t low7 = 0x7F7F7F7F7F7F7F7Full;
+    uint64_t high = ~(((x & low7) + low7) | x | low7);     // 0x80 in every zero byte (no false positives)
+    return (uint32_t)(((high >> 7) * 0x0102040810204080ull) >> 56);
+}
+
+// dest = a ^ b, a word at a time (dest may be a or b)
+static void xor_bytes(uint8_t* dest, const uint8_t* a, const uint8_t* b, size_t count) {
+    size_t k = 0;
+    for (; k + 8 <= count; k += 8) {
+        uint64_t x = load_u64(a + k) ^ load_u64(b + k);
+        memcpy(dest + k, &x, sizeof(x));
+    }
+    for (; k < count; ++k) dest[k] = a[k] ^ b[k];
+}
+
+// End of the literal that starts at the different byte i: the first run of REWIND_MIN_ZERO_RUN
+// equal bytes, or just past the last different byte before the end
+static size_t find_literal_end(const uint8_t* newer, const uint8_t* older, size_t i, size_t size) {
+    size_t literal_end = i + 1;
+    size_t p = i;
+    int carry = 0;              // Equal bytes at the end of the previous word (< REWIND_MIN_ZERO_RUN)
+
+    // 8 bytes at a time: a run can start in the previous word, so its trailing equal bytes are
+    // shifted in below this word's mask before looking for REWIND_MIN_ZERO_RUN set bits in a row
+    for (; p + 8 <= size; p += 8) {
+        uint32_t zero = zero_byte_mask(load_u64(newer + p) ^ load_u64(older + p));
+        uint32_t extended = (zero << carry) | ((1u << carry) - 1);
+        uint32_t runs = extended;
+        for (int k = 1; k < REWIND_MIN_ZERO_RUN; ++k) runs &= extended >> k;
+        if (runs) return p - carry + lowest_bit(runs);
+
+        // No run: at least one byte differs, and fewer than REWIND_MIN_ZERO_RUN equal ones follow it
+        int last_different = highest_bit(~zero & 0xFF);
+        literal_end = p + last_different + 1;
+        carry = 7 - last_different;
+    }
+
+    for (; p < size; ++p) {
+        if (newer[p] != older[p]) {
+            literal_end = p + 1;
+        } else if (p + 1 - literal_end >= REWIND_MIN_ZERO_RUN) {
+            break;
+        }
+    }
+    return literal_end;
+}
+
+size_t rewind_encode_delta(uint8_t* dest, const uint8_t* newer, const uint8_t* older, size_t size) {
+    uint8_t* out = dest;
+    size_t i = 0;
+
+    while (i < size) {
+        // Zero run (equal bytes): whole words, then the equal bytes at the start of the first different word
+        size_t run_start = i;
+        for (;;) {
+            if (i + 8 > size) {
+                while (i < size && newer[i] == older[i]) i++;
+                break;
+            }
+            uint64_t x = load_u64(newer + i) ^ load_u64(older + i);
+            if (x) {
+                i += lowest_bit(x) >> 3;
+                break;
+            }
+            i += 8;
+        }
+        if (i == size) break; // Trailing zeros are implicit
+
+        size_t literal_end = find_literal_end(newer, older, i, size);
+        out = write_varint(out, i - run_start);
+        out = write_varint(out, literal_end - i);
+        xor_bytes(out, newer + i, older + i, literal_end - i);
+        out += literal_end - i;
+        i = literal_end;
+    }
+    return (size_t)(out - dest);
+}
+
+void rewind_apply_delta(uint8_t* image, const uint8_t* delta, size_t delta_size) {
+    const uint8_t* in = delta;
+    const uint8_t* end = delta + delta_size;
+    size_t position = 0;
+
+    while (in < end) {
+        size_t zero_run, literal_count;
+        in = read_varint(in, &zero_run);
+        in = read_varint(in, &literal_count);
+        position += zero_run;
+
+        xor_bytes(image + position, image + position, in, literal_count);
+        in += literal_count;
+        position += literal_count;
+    }
+}
+
+// ##################################################################
+//                          History Ring
+// ##################################################################
+
+static void drop_oldest(RewindBuffer* rewind) {
+    RewindEntry* oldest = &rewind->entries[rewind->entry_first];
+    rewind->history_bytes -= oldest->size;
+    rewind->history_image_bytes -= oldest->image_size;
+    rewind->history_seconds -= oldest->dt;
+
+    rewind->entry_first = (rewind->entry_first + 1) % rewind->max_entries;
+    rewind->entry_count--;
+    if (rewind->entry_count == 0) rewind_clear(rewind);
+}
+
+// Finds room for size contiguous bytes, dropping the oldest ticks until they fit. Returns the offset.
+static size_t reserve_ring(RewindBuffer* rewind, size_t size) {
+    for (;;) {
+        size_t head = rewind->ring_head;
+        size_t position = (head + size <= rewind->ring_size) ? head : 0;
+        if (rewind->entry_count == 0) return position;
+
+        // Live data goes from the oldest entry up to head (wrapping around the end when tail >= head)
+        size_t tail = rewind->entries[rewind->entry_first].offset;
+        bool fits;
+        if (tail < head) {
+            fits = (position == head) || (size <= tail);
+        } else {
+            fits = (position == head) && (head + size <= tail);
+        }
+        if (fits) return position;
+
+        drop_oldest(rewind);
+    }
+}
+
+uint8_t* rewind_begin_snapshot(RewindBuffer* rewind) {
+    return rewind->next;
+}
+
+void rewind_push(RewindBuffer* rewind, size_t image_size, float dt) {
+    // Leftovers of the image that was in next before must read as zero
+    if (rewind->next_dirty_size > image_size) {
+        memset(rewind->next + image_size, 0, rewind->next_dirty_size - image_size);
+    }
+
+    if (rewind->current_size > 0) {
+        size_t size = image_size > rewind->current_size ? image_size : rewind->current_size;
+        size_t delta_size = rewind_encode_delta(rewind->scratch, rewind->next, rewind->current, size);
+        rewind->last_delta_size = (uint32_t)delta_size;
+
+        // Identical images encode to nothing: still take one byte so every entry moves the head
+        size_t reserved = delta_size > 0 ? delta_size : 1;
+
+        if (reserved > rewind->ring_size) {
+            // Cannot be held at all: history restarts from this tick
+            rewind_clear(rewind);
+        } else {
+            if (rewind->entry_count == rewind->max_entries) drop_oldest(rewind);
+            size_t offset = reserve_ring(rewind, reserved);
+            memcpy(rewind->ring + offset, rewind->scratch, delta_size);
+            rewind->ring_head = offset + reserved;
+
+            int index = (rewind->entry_first + rewind->entry_count) % rewind->max_entries;
+            RewindEntry* entry = &rewind->entries[index];
+            entry->offset = offset;
+            entry->size = (uint32_t)delta_size;
+            entry->image_size = (uint32_t)rewind->current_size;
+            entry->dt = dt;
+            rewind->entry_count++;
+
+            rewind->history_bytes += delta_size;
+            rewind->history_image_bytes += rewind->current_size;
+            rewind->history_seconds += dt;
+        }
+    }
+    rewind->last_image_size = (uint32_t)image_size;
+
+    // The new image becomes current; the old one is overwritten by the next snapshot
+    uint8_t* old_image = rewind->current;
+    rewind->current = rewind->next;
+    rewind->next = old_image;
+    rewind->next_dirty_size = rewind->current_size;
+    rewind->current_size = image_size;
+}
+
+const uint8_t* rewind_step_back(RewindBuffer* rewind, size_t* image_size) {
+    if (rewind->entry_count == 0) return 0;
+
+    int index = (rewind->entry_first + rewind->entry_count - 1) % rewind->max_entries;
+    RewindEntry entry = rewind->entries[index];
+
+    // XOR in place: bytes past the older image's size come out as zero on their own
+    rewind_apply_delta(rewind->current, rewind->ring + entry.offset, entry.size);
+    rewind->current_size = entry.image_size;
+
+    rewind->entry_count--;
+    rewind->history_bytes -= entry.size;
+    rewind->history_image_bytes -= entry.image_size;
+    rewind->history_seconds -= entry.dt;
+    if (rewind->entry_count == 0) {
+        rewind_clear(rewind);
+    } else {
+        rewind->ring_head = entry.offset;
+    }
+
+    *image_size = rewind->current_size;
+    return rewind->current;
+}
+
+float rewind_bytes_per_second(RewindBuffer* rewind) {
+    if (rewind->history_seconds <= 0.0f) return 0.0f;
+    return (float)rewind->history_bytes / rewind->history_seconds;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ##################################################################
+//                          Rewind Types
+// ##################################################################
+//
+// History of state snapshots ("images": flat byte blobs written by the
+// game every tick) kept in a fixed-size ring. Only the newest image is
+// stored whole; every older tick is the XOR of two consecutive images,
+// run-length encoded. XOR is symmetric, so the newest image plus its
+// delta gives the previous one back, in place: stepping back one tick
+// costs one pass over the (mostly zero) delta, and the oldest tick can
+// be dropped at any time without needing a keyframe.
+//
+// Delta format: repeated [zero run][literal count][literal bytes], both
+// counts as LEB128 varints, until the longer of the two images is covered.
+// Bytes past an image's size are treated as zero.
+
+// Zero runs shorter than this are kept inside the literal (a new token costs ~2 bytes)
+#define REWIND_MIN_ZERO_RUN 4
+
+// Largest possible delta for an image of this size (all literal, plus the token bytes)
+#define REWIND_MAX_DELTA_SIZE(image_size) ((image_size) + (image_size) / 16 + 32)
+
+// One recorded tick (the delta that turns the image after it into the image before it)
+struct RewindEntry {
+    size_t offset;              // Start of the encoded delta in the ring
+    uint32_t size;              // Encoded bytes
+    uint32_t image_size;        // Size of the older image (the one this delta restores)
+    float dt;                   // Seconds simulated by the tick that followed this image
+};
+
+struct RewindBuffer {
+    // Encoded deltas, in order from the oldest entry (never split across the end of the ring)
+    uint8_t* ring;
+    size_t ring_size;
+    size_t ring_head;           // End of the newest delta (where the next one goes if it fits)
+
+    // Index of the deltas (circular, oldest at entry_first)
+    RewindEntry* entries;
+    int max_entries;
+    int entry_first;
+    int entry_count;
+
+    // Newest image, and the buffer the game writes the next one into
+    uint8_t* current;
+    uint8_t* next;
+    size_t current_size;        // 0 = nothing recorded yet
+    size_t next_dirty_size;     // Bytes of an old image still in next (zeroed before encoding)
+    size_t max_image_size;
+
+    uint8_t* scratch;           // Encoder output (worst case for one image)
+
+    // History held right now
+    size_t history_bytes;       // Sum of the encoded deltas
+    size_t history_image_bytes; // Sum of the images they stand for (for the compression ratio)
+    float history_seconds;
+
+    // Size of the last delta pushed
+    uint32_t last_delta_size;
+    uint32_t last_image_size;
+};
+
+// ##################################################################
+//                          Rewind Functions
+// ##################################################################
+
+// Allocates the ring (ring_size bytes of deltas, at most max_entries ticks) and two image buffers
+bool rewind_init(RewindBuffer* rewind, size_t ring_size, int max_entries, size_t max_image_size);
+
+// Frees the buffers
+void rewind_free(RewindBuffer* rewind);
+
+// Forgets the whole history (the next push starts over)
+void rewind_clear(RewindBuffer* rewind);
+
+// Buffer where the game writes the image of this tick (max_image_size bytes)
+uint8_t* rewind_begin_snapshot(RewindBuffer* rewind);
+
+// Records the image written to rewind_begin_snapshot. dt is the time simulated since the previous push.
+// Old ticks are dropped as needed to make room.
+void rewind_push(RewindBuffer* rewind, size_t image_size, float dt);
+
+// Drops the newest tick and turns the current image into the one before it.
+// Returns the restored image (valid until the next push/step), or null when the history is empty.
+const uint8_t* rewind_step_back(RewindBuffer* rewind, size_t* image_size);
+
+// Encoded bytes per second of history held
+float rewind_bytes_per_second(RewindBuffer* rewind);
+
+// Encodes the delta between two images of size bytes into dest (REWIND_MAX_DELTA_SIZE(size) bytes).
+// Returns the encoded size.
+size_t rewind_encode_delta(uint8_t* dest, const uint8_t* newer, const uint8_t* older, size_t size);
+
+// Applies a delta in place (XOR): image becomes the other side of the delta
+void rewind_apply_delta(uint8_t* image, const uint8_t* delta, size_t delta_size);
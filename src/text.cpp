@@ -0,0 +1,298 @@
+#include "text.h"
+
+#include <assert.h>
+#include <stdlib.h> // Required for malloc
+#include <string.h> // Required for memcmp, memcpy, strlen
+
+// Glyph size of the built-in font, in font pixels
+#define FONT_GLYPH_WIDTH 5
+#define FONT_GLYPH_HEIGHT 7
+
+// Drop shadow: 50% black, one font pixel down and to the right
+#define FONT_SHADOW_COLOR 0x80000000
+
+// ##################################################################
+//                          Built-in Font
+// ##################################################################
+
+// 5x7 glyphs for ASCII 32..126, one byte per row, bit 4 = leftmost column
+static const uint8_t font_glyph_rows[TEXT_CHAR_COUNT][FONT_GLYPH_HEIGHT] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 }, // '!'
+    { 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00 }, // '"'
+    { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A }, // '#'
+    { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 }, // '$'
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // '%'
+    { 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D }, // '&'
+    { 0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 }, // "'"
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // '('
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // ')'
+    { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 }, // '*'
+    { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 }, // '+'
+    { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 }, // ','
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // '-'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // '.'
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // '/'
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // '0'
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // '1'
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // '2'
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // '3'
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // '4'
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // '5'
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // '6'
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // '7'
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // '8'
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // '9'
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // ':'
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 }, // ';'
+    { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 }, // '<'
+    { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 }, // '='
+    { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 }, // '>'
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 }, // '?'
+    { 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E }, // '@'
+    { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // 'A'
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, // 'B'
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // 'C'
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, // 'D'
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // 'E'
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // 'F'
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // 'G'
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // 'H'
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 'I'
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, // 'J'
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // 'K'
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, // 'L'
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // 'M'
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // 'N'
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // 'O'
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // 'P'
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // 'Q'
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // 'R'
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // 'S'
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // 'T'
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // 'U'
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // 'V'
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // 'W'
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // 'X'
+    { 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04 }, // 'Y'
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, // 'Z'
+    { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E }, // '['
+    { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 }, // '\\'
+    { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E }, // ']'
+    { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 }, // '^'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, // '_'
+    { 0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00 }, // '`'
+    { 0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F }, // 'a'
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E }, // 'b'
+    { 0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E }, // 'c'
+    { 0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F }, // 'd'
+    { 0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E }, // 'e'
+    { 0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08 }, // 'f'
+    { 0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E }, // 'g'
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11 }, // 'h'
+    { 0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E }, // 'i'
+    { 0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0C }, // 'j'
+    { 0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12 }, // 'k'
+    { 0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 'l'
+    { 0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11 }, // 'm'
+    { 0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11 }, // 'n'
+    { 0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E }, // 'o'
+    { 0x00, 0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10 }, // 'p'
+    { 0x00, 0x00, 0x0D, 0x13, 0x0F, 0x01, 0x01 }, // 'q'
+    { 0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10 }, // 'r'
+    { 0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E }, // 's'
+    { 0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06 }, // 't'
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D }, // 'u'
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // 'v'
+    { 0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A }, // 'w'
+    { 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11 }, // 'x'
+    { 0x00, 0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E }, // 'y'
+    { 0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F }, // 'z'
+    { 0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02 }, // '{'
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // '|'
+    { 0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08 }, // '}'
+    { 0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00 }, // '~'
+};
+
+// ##################################################################
+//                          Atlas
+// ##################################################################
+
+// Fills a scale x scale block of the atlas
+static void atlas_plot(LoadedBitmap* atlas, int x, int y, int scale, uint32_t color) {
+    for (int sy = 0; sy < scale; ++sy) {
+        uint32_t* pixel = atlas->pixels + (y + sy) * atlas->width + x;
+        for (int sx = 0; sx < scale; ++sx) {
+            *pixel++ = color;
+        }
+    }
+}
+
+bool text_init(TextRenderer* renderer, int scale, uint32_t color) {
+    if (scale < 1) scale = 1;
+
+    TextFont* font = &renderer->font;
+    font->scale = scale;
+    font->cell_width = (FONT_GLYPH_WIDTH + 1) * scale;   // +1 for the shadow column
+    font->cell_height = (FONT_GLYPH_HEIGHT + 1) * scale; // +1 for the shadow row
+    font->advance_x = font->cell_width;
+    font->line_height = font->cell_height + scale;
+
+    int rows = (TEXT_CHAR_COUNT + TEXT_ATLAS_COLUMNS - 1) / TEXT_ATLAS_COLUMNS;
+    font->atlas.width = TEXT_ATLAS_COLUMNS * font->cell_width;
+    font->atlas.height = rows * font->cell_height;
+    font->atlas.pixels = (uint32_t*)calloc((size_t)font->atlas.width * font->atlas.height, sizeof(uint32_t));
+    if (!font->atlas.pixels) return false;
+
+    color |= 0xFF000000; // Glyph pixels are always opaque
+
+    for (int c = 0; c < TEXT_CHAR_COUNT; ++c) {
+        int cell_x = (c % TEXT_ATLAS_COLUMNS) * font->cell_width;
+        int cell_y = (c / TEXT_ATLAS_COLUMNS) * font->cell_height;
+
+        // Shadow first, then the glyph on top of it
+        for (int pass = 0; pass < 2; ++pass) {
+            int offset = (pass == 0) ? scale : 0;
+            uint32_t pass_color = (pass == 0) ? FONT_SHADOW_COLOR : color;
+
+            for (int row = 0; row < FONT_GLYPH_HEIGHT; ++row) {
+                uint8_t bits = font_glyph_rows[c][row];
+                for (int column = 0; column < FONT_GLYPH_WIDTH; ++column) {
+                    if (bits & (0x10 >> column)) {
+                        atlas_plot(&font->atlas, cell_x + column * scale + offset,
+                                   cell_y + row * scale + offset, scale, pass_color);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; ++i) {
+        renderer->cache[i].valid = false;
+    }
+    renderer->cache_hits = 0;
+    renderer->cache_misses = 0;
+    renderer->truncated_layouts = 0;
+    return true;
+}
+
+// ##################################################################
+//                          Layout
+// ##################################################################
+
+// FNV-1a over length characters
+static uint32_t hash_chars(const char* text, int length) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; ++i) {
+        hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Cached layout of the first length characters of text (length <= TEXT_MAX_LAYOUT_CHARS)
+static TextLayout* get_layout(TextRenderer* renderer, const char* text, int length) {
+    uint32_t hash = hash_chars(text, length);
+
+    TextLayout* layout = &renderer->cache[hash & (TEXT_LAYOUT_CACHE_SIZE - 1)];
+    if (layout->valid && layout->hash == hash && layout->length == length &&
+        memcmp(layout->text, text, length) == 0) {
+        renderer->cache_hits++;
+        return layout;
+    }
+
+    // Miss: lay the string out again (the previous occupant of the slot is evicted)
+    renderer->cache_misses++;
+    TextFont* font = &renderer->font;
+
+    layout->valid = true;
+    layout->hash = hash;
+    layout->length = length;
+    memcpy(layout->text, text, length);
+    layout->glyph_count = 0;
+    layout->width = 0;
+    layout->height = length > 0 ? font->cell_height : 0;
+
+    int pen_x = 0;
+    int pen_y = 0;
+    for (int i = 0; i < length; ++i) {
+        int c = (uint8_t)text[i];
+
+        if (c == '\n') {
+            pen_x = 0;
+            pen_y += font->line_height;
+            layout->height = pen_y + font->cell_height;
+            continue;
+        }
+
+        if (c != ' ') {
+            int glyph = c - TEXT_FIRST_CHAR;
+            if (glyph < 0 || glyph >= TEXT_CHAR_COUNT) glyph = '?' - TEXT_FIRST_CHAR;
+
+            TextGlyphQuad* quad = &layout->glyphs[layout->glyph_count++];
+            quad->x = (int16_t)pen_x;
+            quad->y = (int16_t)pen_y;
+            quad->atlas_x = (uint16_t)((glyph % TEXT_ATLAS_COLUMNS) * font->cell_width);
+            quad->atlas_y = (uint16_t)((glyph / TEXT_ATLAS_COLUMNS) * font->cell_height);
+        }
+
+        pen_x += font->advance_x;
+        if (pen_x > layout->width) layout->width = pen_x;
+    }
+
+    return layout;
+}
+
+TextLayout* text_get_layout(TextRenderer* renderer, const char* text) {
+    int length = (int)strlen(text);
+    if (length > TEXT_MAX_LAYOUT_CHARS) {
+        // Callers that need longer strings go through draw_text, which splits them
+        assert(!"text_get_layout: string longer than TEXT_MAX_LAYOUT_CHARS");
+        renderer->truncated_layouts++;
+        length = TEXT_MAX_LAYOUT_CHARS;
+    }
+    return get_layout(renderer, text, length);
+}
+
+// ##################################################################
+//                          Drawing
+// ##################################################################
+
+int draw_text(GameBuffer* buffer, TextRenderer* renderer, const char* text, int x, int y) {
+    TextFont* font = &renderer->font;
+    int glyph_count = 0;
+    int pen_x = x;
+    int pen_y = y;
+
+    // One layout per line, so a line whose numbers change every frame does not
+    // evict the lines around it. Lines longer than a layout continue in chunks.
+    const char* chunk = text;
+    while (*chunk) {
+        int length = 0;
+        while (chunk[length] && chunk[length] != '\n' && length < TEXT_MAX_LAYOUT_CHARS) length++;
+
+        if (length > 0) {
+            TextLayout* layout = get_layout(renderer, chunk, length);
+
+            // Chunk off screen: nothing to do
+            if (pen_x < buffer->width && pen_y < buffer->height &&
+                pen_x + layout->width > 0 && pen_y + layout->height > 0) {
+                // One clipped alpha blit per glyph, straight from the atlas
+                for (int i = 0; i < layout->glyph_count; ++i) {
+                    TextGlyphQuad* quad = &layout->glyphs[i];
+                    draw_bitmap_alpha_region(buffer, &font->atlas, quad->atlas_x, quad->atlas_y,
+                                             font->cell_width, font->cell_height, pen_x + quad->x, pen_y + quad->y);
+                }
+                glyph_count += layout->glyph_count;
+            }
+            pen_x += length * font->advance_x;
+        }
+
+        chunk += length;
+        if (*chunk == '\n') {
+            chunk++;
+            pen_x = x;
+            pen_y += font->line_height;
+        }
+    }
+    return glyph_count;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "render.h"
+
+// ##################################################################
+//                          Text Types
+// ##################################################################
+
+// Printable ASCII range covered by the built-in font
+#define TEXT_FIRST_CHAR 32
+#define TEXT_CHAR_COUNT 95
+
+// Glyphs per atlas row
+#define TEXT_ATLAS_COLUMNS 16
+
+// Cached layouts (direct-mapped by string hash, power of two)
+#define TEXT_LAYOUT_CACHE_SIZE 64
+
+// Longest string a layout can hold (draw_text splits longer lines into chunks)
+#define TEXT_MAX_LAYOUT_CHARS 256
+
+// A font baked into a glyph atlas: 5x7 glyphs with a drop shadow, scaled up
+struct TextFont {
+    LoadedBitmap atlas;     // TEXT_ATLAS_COLUMNS x 6 cells, premultiplied ARGB
+    int scale;              // Size of one font pixel on screen
+    int cell_width;         // Atlas cell (glyph + shadow) in pixels
+    int cell_height;
+    int advance_x;          // Horizontal pen advance per character
+    int line_height;        // Vertical pen advance per '\n'
+};
+
+// One glyph of a layout: where it goes (relative to the text origin) and where it comes from
+struct TextGlyphQuad {
+    int16_t x;
+    int16_t y;
+    uint16_t atlas_x;
+    uint16_t atlas_y;
+};
+
+// A string already converted to glyph quads
+struct TextLayout {
+    bool valid;
+    uint32_t hash;
+    int length;
+    char text[TEXT_MAX_LAYOUT_CHARS];       // Copy of the string (to detect hash collisions)
+    int glyph_count;                        // Visible glyphs (spaces and newlines emit none)
+    int width;                              // Bounding box in pixels
+    int height;
+    TextGlyphQuad glyphs[TEXT_MAX_LAYOUT_CHARS];
+};
+
+struct TextRenderer {
+    TextFont font;
+    TextLayout cache[TEXT_LAYOUT_CACHE_SIZE];
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t truncated_layouts;     // text_get_layout calls cut at TEXT_MAX_LAYOUT_CHARS (asserts in debug)
+};
+
+// ##################################################################
+//                          Text Functions
+// ##################################################################
+
+// Bakes the built-in font into an atlas (scale >= 1, color is RGB and always drawn opaque)
+bool text_init(TextRenderer* renderer, int scale, uint32_t color);
+
+// Returns the cached layout for a whole string, building it on a miss.
+// The string must fit in one layout (TEXT_MAX_LAYOUT_CHARS); longer ones assert and are truncated.
+TextLayout* text_get_layout(TextRenderer* renderer, const char* text);
+
+// Draws a string with its top-left corner at (x, y). Supports '\n'.
+// Each line is laid out (and cached) on its own, in chunks when longer than a layout.
+// Returns the number of glyphs submitted.
+int draw_text(GameBuffer* buffer, TextRenderer* renderer, const char* text, int x, int y);
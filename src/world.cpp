@@ -0,0 +1,230 @@
+#include "world.h"
+
+#include <math.h>   // Required for floorf, ceilf
+#include <stdlib.h> // Required for malloc, free
+
+// ##################################################################
+//                          Level Setup
+// ##################################################################
+
+bool world_init(World* world, float width, float min_y, float height, int max_objects) {
+    world->width = width;
+    world->min_y = min_y;
+    world->height = height;
+    world->object_count = 0;
+    world->max_objects = max_objects;
+    world->objects = (WorldObject*)malloc((size_t)max_objects * sizeof(WorldObject));
+    world->visit_stamp = (uint32_t*)calloc((size_t)max_objects, sizeof(uint32_t));
+    world->query_stamp = 0;
+
+    world->cells_x = (int)ceilf(width / WORLD_CELL_SIZE);
+    world->cells_y = (int)ceilf(height / WORLD_CELL_SIZE);
+    if (world->cells_x < 1) world->cells_x = 1;
+    if (world->cells_y < 1) world->cells_y = 1;
+    world->cell_start = 0;
+    world->cell_objects = 0;
+
+    return world->objects && world->visit_stamp;
+}
+
+void world_free(World* world) {
+    free(world->objects);
+    free(world->visit_stamp);
+    free(world->cell_start);
+    free(world->cell_objects);
+    world->objects = 0;
+    world->visit_stamp = 0;
+    world->cell_start = 0;
+    world->cell_objects = 0;
+    world->object_count = 0;
+}
+
+int world_add_object(World* world, AABB box, uint32_t color) {
+    if (world->object_count >= world->max_objects) return -1;
+
+    int index = world->object_count++;
+    world->objects[index].box = box;
+    world->objects[index].color = color;
+    return index;
+}
+
+// ##################################################################
+//                          Grid
+// ##################################################################
+
+// Grid cell of a coordinate (relative to the level origin), clamped to [0, cell_count - 1].
+// Clamping in float first keeps huge or far-away coordinates from overflowing the int conversion.
+static int grid_cell(float coordinate, int cell_count) {
+    float cell = floorf(coordinate / WORLD_CELL_SIZE);
+    if (!(cell >= 0.0f)) return 0;
+    if (cell >= (float)cell_count) return cell_count - 1;
+    return (int)cell;
+}
+
+// Range of grid cells [min, max] covered by an area. Whatever lies outside the level bounds
+// falls into the edge cells, so objects and queries past the bounds still meet each other.
+static void grid_cell_range(World* world, AABB area, int* min_x, int* min_y, int* max_x, int* max_y) {
+    float local_y = area.y - world->min_y;
+    *min_x = grid_cell(area.x, world->cells_x);
+    *min_y = grid_cell(local_y, world->cells_y);
+    *max_x = grid_cell(area.x + area.w, world->cells_x);
+    *max_y = grid_cell(local_y + area.h, world->cells_y);
+}
+
+bool world_build_grid(World* world) {
+    int cell_count = world->cells_x * world->cells_y;
+
+    free(world->cell_start);
+    free(world->cell_objects);
+    world->cell_start = (int*)calloc((size_t)cell_count + 1, sizeof(int));
+    world->cell_objects = 0;
+    if (!world->cell_start) return false;
+
+    // Pass 1: objects per cell (stored one slot ahead, so the prefix sum below yields start offsets)
+    int entry_count = 0;
+    for (int i = 0; i < world->object_count; ++i) {
+        int min_x, min_y, max_x, max_y;
+        grid_cell_range(world, world->objects[i].box, &min_x, &min_y, &max_x, &max_y);
+
+        for (int y = min_y; y <= max_y; ++y) {
+            for (int x = min_x; x <= max_x; ++x) {
+                world->cell_start[y * world->cells_x + x + 1]++;
+                entry_count++;
+            }
+        }
+    }
+    for (int c = 0; c < cell_count; ++c) {
+        world->cell_start[c + 1] += world->cell_start[c];
+    }
+
+    // Pass 2: fill the cells (cursor starts at each cell's offset)
+    world->cell_objects = (int*)malloc((size_t)(entry_count > 0 ? entry_count : 1) * sizeof(int));
+    int* cursor = (int*)malloc((size_t)cell_count * sizeof(int));
+    if (!world->cell_objects || !cursor) {
+        free(cursor);
+        return false;
+    }
+    for (int c = 0; c < cell_count; ++c) {
+        cursor[c] = world->cell_start[c];
+    }
+
+    for (int i = 0; i < world->object_count; ++i) {
+        int min_x, min_y, max_x, max_y;
+        grid_cell_range(world, world->objects[i].box, &min_x, &min_y, &max_x, &max_y);
+
+        for (int y = min_y; y <= max_y; ++y) {
+            for (int x = min_x; x <= max_x; ++x) {
+                world->cell_objects[cursor[y * world->cells_x + x]++] = i;
+            }
+        }
+    }
+
+    free(cursor);
+    return true;
+}
+
+// Strict overlap: boxes that only touch do not overlap (see world_query in world.h)
+static bool aabb_overlap(AABB a, AABB b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Starts a new query: objects with the current stamp have already been reported
+static uint32_t begin_query(World* world) {
+    if (++world->query_stamp == 0) {
+        // Wrapped around after 4 billion queries: clear the stale stamps
+        for (int i = 0; i < world->max_objects; ++i) world->visit_stamp[i] = 0;
+        world->query_stamp = 1;
+    }
+    return world->query_stamp;
+}
+
+int world_query(World* world, AABB area, int* result, int max_results) {
+    int min_x, min_y, max_x, max_y;
+    if (!world->cell_start) return 0;
+    grid_cell_range(world, area, &min_x, &min_y, &max_x, &max_y);
+
+    uint32_t stamp = begin_query(world);
+    int count = 0;
+
+    for (int y = min_y; y <= max_y; ++y) {
+        for (int x = min_x; x <= max_x; ++x) {
+            int cell = y * world->cells_x + x;
+            for (int e = world->cell_start[cell]; e < world->cell_start[cell + 1]; ++e) {
+                int index = world->cell_objects[e];
+                if (world->visit_stamp[index] == stamp) continue;
+                world->visit_stamp[index] = stamp;
+
+                if (aabb_overlap(world->objects[index].box, area)) {
+                    if (count == max_results) return count;
+                    result[count++] = index;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// ##################################################################
+//                          Camera
+// ##################################################################
+
+void camera_follow(Camera* camera, World* world, float target_x, float target_y) {
+    float x = target_x - 0.5f * (float)camera->width;
+    float y = target_y - 0.5f * (float)camera->height;
+
+    // Never show outside the level (a level smaller than the view stays at its origin)
+    float max_x = world->width - (float)camera->width;
+    float max_y = world->min_y + world->height - (float)camera->height;
+    if (x > max_x) x = max_x;
+    if (y > max_y) y = max_y;
+    if (x < 0.0f) x = 0.0f;
+    if (y < world->min_y) y = world->min_y;
+
+    // Whole pixels: static geometry does not shimmer while the camera moves
+    camera->x = floorf(x + 0.5f);
+    camera->y = floorf(y + 0.5f);
+}
+
+AABB camera_view(Camera* camera) {
+    AABB view = { camera->x, camera->y, (float)camera->width, (float)camera->height };
+    return view;
+}
+
+// ##################################################################
+//                          Rendering
+// ##################################################################
+
+void world_render(GameBuffer* buffer, World* world, Camera* camera, CullStats* stats) {
+    AABB view = camera_view(camera);
+    stats->objects_in_world = world->object_count;
+    stats->candidates = 0;
+    stats->visible = 0;
+
+    int min_x, min_y, max_x, max_y;
+    if (!world->cell_start) return;
+    grid_cell_range(world, view, &min_x, &min_y, &max_x, &max_y);
+
+    uint32_t stamp = begin_query(world);
+
+    // Only the cells under the view are visited: nothing else in the level costs anything
+    for (int y = min_y; y <= max_y; ++y) {
+        for (int x = min_x; x <= max_x; ++x) {
+            int cell = y * world->cells_x + x;
+            for (int e = world->cell_start[cell]; e < world->cell_start[cell + 1]; ++e) {
+                int index = world->cell_objects[e];
+                if (world->visit_stamp[index] == stamp) continue;
+                world->visit_stamp[index] = stamp;
+                stats->candidates++;
+
+                WorldObject* object = &world->objects[index];
+                if (!aabb_overlap(object->box, view)) continue;
+
+                // World -> screen
+                int screen_x = (int)floorf(object->box.x - camera->x);
+                int screen_y = (int)floorf(object->box.y - camera->y);
+                draw_rect(buffer, screen_x, screen_y, (int)object->box.w, (int)object->box.h, object->color);
+                stats->visible++;
+            }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "render.h"
+
+// ##################################################################
+//                          World Types
+// ##################################################################
+//
+// Level geometry lives in world space (pixels, y down) and can be much
+// larger than the screen. Static objects are bucketed in a uniform grid
+// so both culling and collision queries only touch the cells around the
+// area of interest: their cost follows what is near, not the level size.
+
+// Grid cell size in world pixels
+#define WORLD_CELL_SIZE 256
+
+struct AABB {
+    float x, y;
+    float w, h;
+};
+
+// A static piece of level geometry (drawn as a solid rectangle)
+struct WorldObject {
+    AABB box;
+    uint32_t color;
+};
+
+struct World {
+    float width;                // Level bounds: [0, width) x [min_y, min_y + height) (sizes the grid)
+    float min_y;
+    float height;
+
+    int object_count;
+    int max_objects;
+    WorldObject* objects;
+
+    // Uniform grid (compressed rows: the objects of cell c are cell_objects[cell_start[c] .. cell_start[c + 1]])
+    int cells_x;
+    int cells_y;
+    int* cell_start;
+    int* cell_objects;
+
+    // Objects spanning several cells are reported once per query
+    uint32_t* visit_stamp;
+    uint32_t query_stamp;
+};
+
+struct Camera {
+    float x, y;                 // World position of the top-left corner of the view (whole pixels)
+    int width, height;          // View size in pixels
+};
+
+// Per-frame culling counters
+struct CullStats {
+    int objects_in_world;
+    int candidates;             // Objects found in the grid cells under the view
+    int visible;                // Candidates that actually overlap the view (drawn)
+};
+
+// ##################################################################
+//                          World Functions
+// ##################################################################
+
+// Allocates a level with room for max_objects. Call world_build_grid after adding objects.
+bool world_init(World* world, float width, float min_y, float height, int max_objects);
+
+// Frees the level
+void world_free(World* world);
+
+// Adds a static object. Returns its index, or -1 if the level is full.
+// Objects may stick out of (or lie entirely outside) the level bounds: the grid keeps them in its edge cells.
+int world_add_object(World* world, AABB box, uint32_t color);
+
+// (Re)builds the grid from the current objects
+bool world_build_grid(World* world);
+
+// Writes the indices of the objects overlapping area (each once) to result. Returns how many were written.
+// Overlap is strict: boxes that only share an edge do not count. This differs from the old
+// check_aabb_collision (inclusive), on purpose: a player resting exactly on a platform touches it,
+// and an inclusive test would report it to every horizontal move and stop the player from walking.
+// Landing still works because gravity moves the next vertical probe into the platform every tick.
+int world_query(World* world, AABB area, int* result, int max_results);
+
+// Centers the camera on a world point, clamped to the level bounds and snapped to whole pixels
+void camera_follow(Camera* camera, World* world, float target_x, float target_y);
+
+// The part of the world the camera sees
+AABB camera_view(Camera* camera);
+
+// Culls the level against the camera view and draws what is visible
+void world_render(GameBuffer* buffer, World* world, Camera* camera, CullStats* stats);
@@ -0,0 +1,162 @@
+// Resampler quality: sines resampled through every filter bank, compared with
+// the analytic signal at the output rate.
+//   - Passband tone: the output must match the ideal resampled sine (SNR).
+//   - Stopband tone (banks for ratios > 1): a tone above the output Nyquist
+//     frequency must be filtered out instead of folding back (alias rejection).
+//   - One-shot end: the filter tail rings out to silence before the voice stops.
+
+#include "audio_resampler.h"
+#include "test.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_OUTPUT_RATE 48000
+#define TEST_OUTPUT_FRAMES 8192
+
+// Frames skipped at both ends of the output (the kernel reads silence there)
+#define TEST_EDGE_FRAMES 64
+
+static const double pi = 3.14159265358979323846;
+
+static LoadedSound make_sine_sound(int samples_per_second, double frequency, uint32_t sample_count) {
+    LoadedSound sound = {};
+    sound.samples_per_second = samples_per_second;
+    sound.channel_count = 1;
+    sound.sample_count = sample_count;
+    sound.samples[0] = (float*)malloc(sample_count * sizeof(float));
+    sound.samples[1] = sound.samples[0];
+    for (uint32_t i = 0; i < sample_count; ++i) {
+        sound.samples[0][i] = (float)(0.5 * sin(2.0 * pi * frequency * (double)i / (double)samples_per_second));
+    }
+    return sound;
+}
+
+// Plays the sound once (pitch 1) into a mono output buffer of TEST_OUTPUT_FRAMES
+static void render_sound(LoadedSound* sound, float* output) {
+    static SoundMixer mixer;
+    memset(&mixer, 0, sizeof(mixer));
+    mixer.output_samples_per_second = TEST_OUTPUT_RATE;
+
+    static float right[TEST_OUTPUT_FRAMES];
+    memset(output, 0, TEST_OUTPUT_FRAMES * sizeof(float));
+    memset(right, 0, sizeof(right));
+
+    mixer_play_sound(&mixer, sound, 1.0f, 1.0f, false);
+    mixer_mix_voices(&mixer, output, right, TEST_OUTPUT_FRAMES);
+}
+
+// Signal-to-error ratio (dB) of the output against the ideal sine at the output rate
+static double passband_snr(const float* output, double frequency) {
+    double signal = 0.0;
+    double error = 0.0;
+    for (int n = TEST_EDGE_FRAMES; n < TEST_OUTPUT_FRAMES - TEST_EDGE_FRAMES; ++n) {
+        double ideal = 0.5 * sin(2.0 * pi * frequency * (double)n / (double)TEST_OUTPUT_RATE);
+        double difference = (double)output[n] - ideal;
+        signal += ideal * ideal;
+        error += difference * difference;
+    }
+    return 10.0 * log10(signal / (error > 1e-30 ? error : 1e-30));
+}
+
+// Output power relative to the input sine (dB, negative = attenuated)
+static double relative_level(const float* output) {
+    double power = 0.0;
+    int count = 0;
+    for (int n = TEST_EDGE_FRAMES; n < TEST_OUTPUT_FRAMES - TEST_EDGE_FRAMES; ++n) {
+        power += (double)output[n] * output[n];
+        count++;
+    }
+    double input_power = 0.5 * 0.5 * 0.5; // Mean square of a 0.5 amplitude sine
+    return 10.0 * log10((power / count + 1e-30) / input_power);
+}
+
+struct BankCase {
+    const char* name;
+    double ratio;               // Source rate / output rate (selects the bank)
+    double passband_hz;         // Inside the passband of that bank
+    double min_snr_db;
+    double stopband_hz;         // Above the output Nyquist frequency (0 = no aliasing possible)
+    double max_alias_db;
+};
+
+static void test_filter_banks() {
+    static const BankCase cases[] = {
+        // Upsampling (22050 -> 48000): nothing can alias, only the passband matters
+        { "bank 1.0 (upsampling)", 22050.0 / 48000.0, 3000.0, 65.0, 0.0, 0.0 },
+        { "bank 1.0 (same rate)", 1.0, 3000.0, 65.0, 0.0, 0.0 },
+        { "bank 1.5", 1.5, 3000.0, 65.0, 34000.0, -60.0 },
+        { "bank 2.0", 2.0, 3000.0, 65.0, 45000.0, -60.0 },
+        { "bank 3.0", 3.0, 3000.0, 65.0, 68000.0, -60.0 },
+        { "bank 4.0", 4.0, 3000.0, 65.0, 90000.0, -60.0 },
+    };
+    static float output[TEST_OUTPUT_FRAMES];
+
+    for (int c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); ++c) {
+        const BankCase* test = &cases[c];
+        int source_rate = (int)(test->ratio * TEST_OUTPUT_RATE + 0.5);
+        uint32_t source_count = (uint32_t)(TEST_OUTPUT_FRAMES * test->ratio) + RESAMPLER_TAPS * 2;
+
+        LoadedSound passband = make_sine_sound(source_rate, test->passband_hz, source_count);
+        render_sound(&passband, output);
+        double snr = passband_snr(output, test->passband_hz);
+        printf("%-24s passband %6.0f Hz: SNR %6.1f dB\n", test->name, test->passband_hz, snr);
+        TEST_CHECK_MESSAGE(snr >= test->min_snr_db, "%s: SNR %.1f dB < %.1f dB", test->name, snr, test->min_snr_db);
+        free(passband.samples[0]);
+
+        if (test->stopband_hz > 0.0) {
+            LoadedSound stopband = make_sine_sound(source_rate, test->stopband_hz, source_count);
+            render_sound(&stopband, output);
+            double level = relative_level(output);
+            printf("%-24s stopband %6.0f Hz: alias %6.1f dB\n", test->name, test->stopband_hz, level);
+            TEST_CHECK_MESSAGE(level <= test->max_alias_db, "%s: alias %.1f dB > %.1f dB",
+                               test->name, level, test->max_alias_db);
+            free(stopband.samples[0]);
+        }
+    }
+}
+
+// A one-shot that stops on a full-scale sample must still fade to silence: the
+// voice plays the filter tail (half a kernel of zeros) before it goes inactive
+static void test_one_shot_tail() {
+    static SoundMixer mixer;
+    memset(&mixer, 0, sizeof(mixer));
+    mixer.output_samples_per_second = TEST_OUTPUT_RATE;
+
+    LoadedSound sound = {};
+    sound.samples_per_second = TEST_OUTPUT_RATE;
+    sound.channel_count = 1;
+    sound.sample_count = 1000;
+    sound.samples[0] = (float*)malloc(sound.sample_count * sizeof(float));
+    sound.samples[1] = sound.samples[0];
+    for (uint32_t i = 0; i < sound.sample_count; ++i) sound.samples[0][i] = 0.5f;
+
+    static float left[2000];
+    static float right[2000];
+    for (int i = 0; i < 2000; ++i) left[i] = right[i] = 0.0f;
+
+    PlayingSound* voice = mixer_play_sound(&mixer, &sound, 1.0f, 1.0f, false);
+    TEST_CHECK(voice != 0);
+    mixer_mix_voices(&mixer, left, right, 2000);
+    TEST_CHECK(!voice->active);
+
+    // Still playing right after the last sample, silent by the time it stops
+    int last = 0;
+    for (int i = 0; i < 2000; ++i) {
+        if (left[i] != 0.0f) last = i;
+    }
+    printf("one-shot tail: last sample %d, last written frame %d, value %g\n",
+           (int)sound.sample_count - 1, last, left[last]);
+    TEST_CHECK(last > (int)sound.sample_count);
+    TEST_CHECK_MESSAGE(fabsf(left[last]) < 0.01f, "tail ends at %g", left[last]);
+
+    free(sound.samples[0]);
+}
+
+int main() {
+    resampler_init_tables();
+    test_filter_banks();
+    test_one_shot_tail();
+    return test_report("audio_resampler_test");
+}
@@ -0,0 +1,431 @@
+// BMP decoder: valid files decode to the right pixels, malformed files are rejected
+// with an error code, never decoded from memory outside the buffer.
+//   - Decoded pixels of bottom-up and top-down 24-bit, 32-bit BI_RGB (with and without
+//     alpha), BI_BITFIELDS and BI_ALPHABITFIELDS files, at every kernel level.
+//   - Every truncation of valid files (24-bit, 32-bit BI_RGB, BI_BITFIELDS).
+//   - Oversized, zero and negative dimensions, including INT32_MIN height.
+//   - Bad BI_BITFIELDS masks and masks cut off by the end of the file.
+//   - Pixel data offsets inside the headers, past the end and near 4 GB.
+//   - Random byte corruption of the header area.
+// Each file is copied so that it ends exactly at a page boundary followed by an
+// inaccessible page: reading one byte past the buffer crashes the test.
+
+#include "bmp.h"
+#include "kernels.h"
+#include "test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// ##################################################################
+//                          Guarded Buffers
+// ##################################################################
+
+struct GuardedBuffer {
+    uint8_t* base;      // Start of the mapping
+    size_t mapped;      // Bytes mapped (data pages + the guard page)
+    uint8_t* data;      // Copy of the file, ending where the guard page starts
+};
+
+static size_t page_size() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+static GuardedBuffer guarded_copy(const uint8_t* file, size_t size) {
+    size_t page = page_size();
+    size_t data_pages = (size + page - 1) / page;
+    if (data_pages == 0) data_pages = 1;
+
+    GuardedBuffer buffer;
+    buffer.mapped = (data_pages + 1) * page;
+#ifdef _WIN32
+    buffer.base = (uint8_t*)VirtualAlloc(0, buffer.mapped, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    DWORD old_protect;
+    VirtualProtect(buffer.base + data_pages * page, page, PAGE_NOACCESS, &old_protect);
+#else
+    buffer.base = (uint8_t*)mmap(0, buffer.mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    mprotect(buffer.base + data_pages * page, page, PROT_NONE);
+#endif
+    buffer.data = buffer.base + data_pages * page - size;
+    if (size > 0) memcpy(buffer.data, file, size);
+    return buffer;
+}
+
+static void guarded_free(GuardedBuffer* buffer) {
+#ifdef _WIN32
+    VirtualFree(buffer->base, 0, MEM_RELEASE);
+#else
+    munmap(buffer->base, buffer->mapped);
+#endif
+}
+
+// Decodes a file from a guarded copy of its first size bytes
+static BmpError decode_guarded(const uint8_t* file, size_t size, LoadedBitmap* bitmap) {
+    GuardedBuffer buffer = guarded_copy(file, size);
+    BmpError error = bmp_decode(buffer.data, size, bitmap);
+    guarded_free(&buffer);
+    return error;
+}
+
+// Decodes and expects a specific error (and an empty result)
+static void expect_error(const char* what, const uint8_t* file, size_t size, BmpError expected) {
+    LoadedBitmap bitmap;
+    BmpError error = decode_guarded(file, size, &bitmap);
+    TEST_CHECK_MESSAGE(error == expected, "%s: got \"%s\", expected \"%s\"",
+                       what, bmp_error_name(error), bmp_error_name(expected));
+    TEST_CHECK_MESSAGE(bitmap.pixels == 0 || error == BMP_OK, "%s: pixels left allocated after an error", what);
+    if (error == BMP_OK) bmp_free(&bitmap);
+}
+
+// ##################################################################
+//                          Test Files
+// ##################################################################
+
+static void write_u16(uint8_t* bytes, uint16_t value) {
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+}
+
+static void write_u32(uint8_t* bytes, uint32_t value) {
+    for (int i = 0; i < 4; ++i) bytes[i] = (uint8_t)(value >> (8 * i));
+}
+
+#define TEST_FILE_CAPACITY 4096
+
+struct TestFile {
+    uint8_t bytes[TEST_FILE_CAPACITY];
+    size_t size;
+};
+
+// Valid file: 40-byte header, then the masks for BI_BITFIELDS (3) / BI_ALPHABITFIELDS (4), then rows
+// padded to 4 bytes. The last row is not padded, so every shorter prefix is genuinely truncated
+static TestFile make_file(int width, int height, int bits_per_pixel, uint32_t compression) {
+    TestFile file;
+    memset(&file, 0, sizeof(file));
+
+    size_t mask_bytes = (compression == 3) ? 12 : (compression == 6) ? 16 : 0;
+    size_t pixel_offset = 14 + 40 + mask_bytes;
+    size_t row_bytes = (size_t)width * (bits_per_pixel / 8);
+    size_t stride = (row_bytes + 3) / 4 * 4;
+    size_t rows = (size_t)(height < 0 ? -height : height);
+    file.size = pixel_offset + stride * (rows - 1) + row_bytes;
+
+    uint8_t* b = file.bytes;
+    b[0] = 'B';
+    b[1] = 'M';
+    write_u32(b + 2, (uint32_t)file.size);
+    write_u32(b + 10, (uint32_t)pixel_offset);
+    write_u32(b + 14, 40);
+    write_u32(b + 18, (uint32_t)width);
+    write_u32(b + 22, (uint32_t)height);
+    write_u16(b + 26, 1);
+    write_u16(b + 28, (uint16_t)bits_per_pixel);
+    write_u32(b + 30, compression);
+    if (mask_bytes) {
+        write_u32(b + 54, 0x00FF0000);
+        write_u32(b + 58, 0x0000FF00);
+        write_u32(b + 62, 0x000000FF);
+        if (mask_bytes == 16) write_u32(b + 66, 0xFF000000);
+    }
+    for (size_t i = pixel_offset; i < file.size; ++i) b[i] = (uint8_t)(i * 37);
+    return file;
+}
+
+// ##################################################################
+//                          Cases
+// ##################################################################
+
+// A channel straight from the definition: the masked bits scaled to 0..255 (mask 0 = missing)
+static uint32_t reference_channel(uint32_t pixel, uint32_t mask, uint32_t missing) {
+    if (mask == 0) return missing;
+
+    int shift = 0;
+    while (!((mask >> shift) & 1)) shift++;
+    uint32_t max_value = mask >> shift;
+    uint32_t value = (pixel & mask) >> shift;
+    if (max_value >= 255) {
+        while (max_value > 255) {   // Wider than 8 bits: keep the top 8
+            max_value >>= 1;
+            value >>= 1;
+        }
+        return value;
+    }
+    return (value * 255 + max_value / 2) / max_value;
+}
+
+struct PixelCase {
+    const char* name;
+    int width;
+    int height;             // Negative = top-down
+    int bits_per_pixel;
+    uint32_t compression;
+    uint32_t masks[4];      // R, G, B, A written to the file (BI_BITFIELDS: only the first 3)
+    bool clear_alpha;       // 32-bit BI_RGB with every 4th byte zero: decodes as opaque
+    int alpha_file_row;     // With clear_alpha: file row that keeps its 4th bytes (-1 = none)
+};
+
+// Expected output pixel (x, y), computed from the raw file bytes independently of the decoder
+static uint32_t expected_pixel(const PixelCase* c, const TestFile* file, int x, int y) {
+    int rows = c->height < 0 ? -c->height : c->height;
+    int file_y = (c->height < 0) ? y : rows - 1 - y;
+    size_t row_bytes = (size_t)c->width * (c->bits_per_pixel / 8);
+    size_t stride = (row_bytes + 3) / 4 * 4;
+    size_t pixel_offset = (size_t)file->bytes[10] | ((size_t)file->bytes[11] << 8);
+    const uint8_t* p = file->bytes + pixel_offset + stride * file_y + (size_t)x * (c->bits_per_pixel / 8);
+
+    if (c->bits_per_pixel == 24) {
+        return 0xFF000000 | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+    }
+
+    uint32_t raw = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    bool alpha_cleared = c->clear_alpha && c->alpha_file_row < 0;
+    uint32_t alpha_mask = alpha_cleared ? 0 : (c->compression == 3) ? 0 : c->masks[3];
+    uint32_t a = reference_channel(raw, alpha_mask, 255);
+    uint32_t r = reference_channel(raw, c->masks[0], 0);
+    uint32_t g = reference_channel(raw, c->masks[1], 0);
+    uint32_t b = reference_channel(raw, c->masks[2], 0);
+
+    // Premultiplied: round(c * a / 255) (never a tie: c * a * 2 is even, 255 * odd is odd)
+    r = (r * a + 127) / 255;
+    g = (g * a + 127) / 255;
+    b = (b * a + 127) / 255;
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Decodes every layout and compares each pixel with the reference, at every kernel level
+// (37 pixels per row: SIMD bodies plus a tail at all widths)
+static void test_valid_files() {
+    static const PixelCase cases[] = {
+        { "24-bit bottom-up", 37, 5, 24, 0, { 0 }, false, -1 },
+        { "24-bit top-down", 37, -5, 24, 0, { 0 }, false, -1 },
+        { "32-bit BI_RGB bottom-up", 37, 5, 32, 0, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }, false, -1 },
+        { "32-bit BI_RGB top-down", 37, -5, 32, 0, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }, false, -1 },
+        { "32-bit BI_RGB zero alpha", 37, 5, 32, 0, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }, true, -1 },
+        { "32-bit BI_RGB zero alpha top-down", 37, -5, 32, 0, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }, true, -1 },
+        // Alpha only in the row decoded last: every row done as opaque until then gets redone
+        { "32-bit BI_RGB alpha in the last row", 37, 5, 32, 0, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }, true, 0 },
+        { "32-bit BI_RGB alpha in the last row top-down", 37, -5, 32, 0, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }, true, 4 },
+        { "BI_BITFIELDS native", 37, 5, 32, 3, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0 }, false, -1 },
+        { "BI_BITFIELDS swapped R/B", 37, -5, 32, 3, { 0x000000FF, 0x0000FF00, 0x00FF0000, 0 }, false, -1 },
+        { "BI_BITFIELDS 5-6-5", 37, 5, 32, 3, { 0x0000F800, 0x000007E0, 0x0000001F, 0 }, false, -1 },
+        { "BI_BITFIELDS 10-bit", 37, 5, 32, 3, { 0x3FF00000, 0x000FFC00, 0x000003FF, 0 }, false, -1 },
+        { "BI_ALPHABITFIELDS native", 37, -5, 32, 6, { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }, false, -1 },
+        { "BI_ALPHABITFIELDS alpha low", 37, 5, 32, 6, { 0x0000FF00, 0x00FF0000, 0xFF000000, 0x000000FF }, false, -1 },
+    };
+    int case_count = (int)(sizeof(cases) / sizeof(cases[0]));
+
+    CpuIsa best = cpu_best_isa(detect_cpu_features());
+    for (int level = CPU_ISA_SCALAR; level <= best; ++level) {
+        CpuIsa isa = kernels_init((CpuIsa)level);
+
+        for (int i = 0; i < case_count; ++i) {
+            const PixelCase* c = &cases[i];
+            TestFile file = make_file(c->width, c->height, c->bits_per_pixel, c->compression);
+            if (c->compression == 3 || c->compression == 6) {
+                for (int m = 0; m < (c->compression == 6 ? 4 : 3); ++m) write_u32(file.bytes + 54 + 4 * m, c->masks[m]);
+            }
+            if (c->clear_alpha) {
+                size_t pixel_offset = 14 + 40;
+                size_t row_bytes = (size_t)c->width * 4;
+                for (size_t p = pixel_offset + 3; p < file.size; p += 4) {
+                    if ((int)((p - pixel_offset) / row_bytes) != c->alpha_file_row) file.bytes[p] = 0;
+                }
+            }
+
+            LoadedBitmap bitmap;
+            BmpError error = decode_guarded(file.bytes, file.size, &bitmap);
+            TEST_CHECK_MESSAGE(error == BMP_OK, "%s (%s): %s", c->name, cpu_isa_name(isa), bmp_error_name(error));
+            if (error != BMP_OK) continue;
+
+            int rows = c->height < 0 ? -c->height : c->height;
+            TEST_CHECK(bitmap.width == c->width && bitmap.height == rows);
+
+            int mismatches = 0;
+            uint32_t first_got = 0, first_expected = 0;
+            int first_x = 0, first_y = 0;
+            for (int y = 0; y < rows; ++y) {
+                for (int x = 0; x < c->width; ++x) {
+                    uint32_t expected = expected_pixel(c, &file, x, y);
+                    uint32_t got = bitmap.pixels[y * bitmap.width + x];
+                    if (got != expected && mismatches++ == 0) {
+                        first_got = got;
+                        first_expected = expected;
+                        first_x = x;
+                        first_y = y;
+                    }
+                }
+            }
+            TEST_CHECK_MESSAGE(mismatches == 0, "%s (%s): %d wrong pixels, first at (%d, %d): %08X, expected %08X",
+                               c->name, cpu_isa_name(isa), mismatches, first_x, first_y, first_got, first_expected);
+            bmp_free(&bitmap);
+        }
+    }
+    kernels_init(CPU_ISA_SCALAR);
+}
+
+static void test_truncation() {
+    TestFile files[] = {
+        make_file(8, 6, 24, 0),
+        make_file(8, -6, 32, 0),
+        make_file(8, 6, 32, 3),
+    };
+    for (int f = 0; f < 3; ++f) {
+        for (size_t size = 0; size < files[f].size; ++size) {
+            LoadedBitmap bitmap;
+            BmpError error = decode_guarded(files[f].bytes, size, &bitmap);
+            TEST_CHECK_MESSAGE(error != BMP_OK, "file %d cut to %zu of %zu bytes decoded", f, size, files[f].size);
+            if (error == BMP_OK) bmp_free(&bitmap);
+        }
+    }
+}
+
+static void test_dimensions() {
+    struct Case { const char* name; int32_t width; int32_t height; BmpError expected; };
+    static const Case cases[] = {
+        { "zero width", 0, 6, BMP_ERROR_BAD_DIMENSIONS },
+        { "zero height", 8, 0, BMP_ERROR_BAD_DIMENSIONS },
+        { "negative width", -8, 6, BMP_ERROR_BAD_DIMENSIONS },
+        { "width over the limit", BMP_MAX_DIMENSION + 1, 1, BMP_ERROR_BAD_DIMENSIONS },
+        { "height over the limit", 1, BMP_MAX_DIMENSION + 1, BMP_ERROR_BAD_DIMENSIONS },
+        { "top-down height over the limit", 1, -(BMP_MAX_DIMENSION + 1), BMP_ERROR_BAD_DIMENSIONS },
+        { "INT32_MAX width", 0x7FFFFFFF, 1, BMP_ERROR_BAD_DIMENSIONS },
+        { "INT32_MIN height", 8, (int32_t)0x80000000, BMP_ERROR_BAD_DIMENSIONS },
+        { "huge height, small file", 8, BMP_MAX_DIMENSION, BMP_ERROR_TRUNCATED },
+        { "huge top-down height, small file", 8, -BMP_MAX_DIMENSION, BMP_ERROR_TRUNCATED },
+        { "huge width, small file", BMP_MAX_DIMENSION, 6, BMP_ERROR_TRUNCATED },
+    };
+    for (int c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); ++c) {
+        TestFile file = make_file(8, 6, 24, 0);
+        write_u32(file.bytes + 18, (uint32_t)cases[c].width);
+        write_u32(file.bytes + 22, (uint32_t)cases[c].height);
+        expect_error(cases[c].name, file.bytes, file.size, cases[c].expected);
+    }
+}
+
+static void test_masks() {
+    struct Case { const char* name; uint32_t masks[3]; };
+    static const Case cases[] = {
+        { "empty red mask", { 0, 0x0000FF00, 0x000000FF } },
+        { "mask with a hole", { 0x00FF00F0, 0x0000FF00, 0x0000000F } },
+        { "overlapping masks", { 0x00FFFF00, 0x0000FF00, 0x000000FF } },
+        { "all masks equal", { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF } },
+    };
+    for (int c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); ++c) {
+        TestFile file = make_file(8, 6, 32, 3);
+        for (int i = 0; i < 3; ++i) write_u32(file.bytes + 54 + 4 * i, cases[c].masks[i]);
+        expect_error(cases[c].name, file.bytes, file.size, BMP_ERROR_BAD_MASKS);
+    }
+
+    // BI_ALPHABITFIELDS reads a 4th (alpha) mask after the header: the file ends before it
+    TestFile file = make_file(8, 6, 32, 3);
+    write_u32(file.bytes + 30, 6);
+    expect_error("alpha mask cut off", file.bytes, 14 + 40 + 12, BMP_ERROR_TRUNCATED);
+
+    // Alpha mask overlapping a color mask
+    file = make_file(8, 6, 32, 3);
+    write_u32(file.bytes + 30, 6);
+    write_u32(file.bytes + 10, 14 + 40 + 16);
+    write_u32(file.bytes + 66, 0x000000FF);
+    expect_error("alpha mask over blue", file.bytes, file.size, BMP_ERROR_BAD_MASKS);
+
+    // Bit depth / compression combinations that are not handled
+    file = make_file(8, 6, 24, 0);
+    write_u32(file.bytes + 30, 3);
+    expect_error("24-bit BI_BITFIELDS", file.bytes, file.size, BMP_ERROR_UNSUPPORTED_FORMAT);
+    file = make_file(8, 6, 24, 0);
+    write_u16(file.bytes + 28, 8);
+    expect_error("8-bit palette", file.bytes, file.size, BMP_ERROR_UNSUPPORTED_FORMAT);
+}
+
+static void test_offsets_and_headers() {
+    TestFile file = make_file(8, 6, 24, 0);
+    uint32_t offsets[] = { 0, 14, 14 + 39 };
+    for (int i = 0; i < 3; ++i) {
+        TestFile bad = file;
+        write_u32(bad.bytes + 10, offsets[i]);
+        expect_error("offset inside the headers", bad.bytes, bad.size, BMP_ERROR_BAD_OFFSET);
+    }
+
+    uint32_t past_end[] = { (uint32_t)file.size, (uint32_t)file.size - 1, 0x7FFFFFFF, 0xFFFFFFFF };
+    for (int i = 0; i < 4; ++i) {
+        TestFile bad = file;
+        write_u32(bad.bytes + 10, past_end[i]);
+        expect_error("offset past the pixel data", bad.bytes, bad.size, BMP_ERROR_TRUNCATED);
+    }
+
+    uint32_t header_sizes[] = { 0, 12, 64, 0xFFFFFFFF };
+    for (int i = 0; i < 4; ++i) {
+        TestFile bad = file;
+        write_u32(bad.bytes + 14, header_sizes[i]);
+        expect_error("unknown header size", bad.bytes, bad.size, BMP_ERROR_UNSUPPORTED_HEADER);
+    }
+
+    // V5 header declared, file ends inside it
+    TestFile bad = file;
+    write_u32(bad.bytes + 14, 124);
+    expect_error("V5 header cut off", bad.bytes, 14 + 100, BMP_ERROR_TRUNCATED);
+
+    bad = file;
+    bad.bytes[0] = 'M';
+    expect_error("bad signature", bad.bytes, bad.size, BMP_ERROR_NOT_BMP);
+}
+
+// Random corruption of the headers and masks: any result is fine except reading out of bounds
+// (the guard page) or returning a bitmap that does not match its own dimensions
+static void test_random_corruption() {
+    TestFile files[] = {
+        make_file(8, 6, 24, 0),
+        make_file(8, -6, 32, 0),
+        make_file(8, 6, 32, 3),
+    };
+    uint32_t random_state = 0x1234567u;
+    int decoded = 0;
+
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        TestFile file = files[iteration % 3];
+        int flips = 1 + iteration % 4;
+        for (int i = 0; i < flips; ++i) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 17;
+            random_state ^= random_state << 5;
+            size_t position = random_state % 66;        // Headers + masks
+            file.bytes[position] = (uint8_t)(random_state >> 8);
+        }
+
+        LoadedBitmap bitmap;
+        BmpError error = decode_guarded(file.bytes, file.size, &bitmap);
+        if (error == BMP_OK) {
+            decoded++;
+            bool sane = bitmap.pixels && bitmap.width > 0 && bitmap.height > 0 &&
+                        bitmap.width <= BMP_MAX_DIMENSION && bitmap.height <= BMP_MAX_DIMENSION;
+            TEST_CHECK_MESSAGE(sane, "corruption %d decoded to %dx%d", iteration, bitmap.width, bitmap.height);
+            bmp_free(&bitmap);
+        } else {
+            TEST_CHECK(bitmap.pixels == 0);
+        }
+    }
+    printf("random corruption: %d of 20000 files still decoded\n", decoded);
+}
+
+int main() {
+    test_valid_files();
+    test_truncation();
+    test_dimensions();
+    test_masks();
+    test_offsets_and_headers();
+    test_random_corruption();
+    return test_report("bmp_test");
+}
@@ -0,0 +1,177 @@
+// Job system under contention: every job must run exactly once, and nothing may hang.
+//   - Nested submits: jobs running on workers submit and wait on their own children.
+//   - Last-item races: single-job rounds where the owner pops the only job while
+//     every other thread is trying to steal it.
+//   - Sleep/wake: workers go to sleep on an empty system, then a burst arrives and
+//     must be picked up by them (the main thread does not help).
+// The system is oversubscribed (more threads than cores) so preemption lands in
+// the middle of the deque operations.
+
+#include "job_system.h"
+#include "test.h"
+
+#include <chrono>
+#include <string.h>
+
+#define TEST_INDEX_COUNT (1 << 16)
+
+// Runs of every index (exactly-once check)
+static std::atomic<uint32_t> runs[TEST_INDEX_COUNT];
+
+static void reset_runs() {
+    for (int i = 0; i < TEST_INDEX_COUNT; ++i) runs[i].store(0, std::memory_order_relaxed);
+}
+
+// Number of indices in [0, count) that did not run exactly once
+static int count_wrong_runs(int count) {
+    int wrong = 0;
+    for (int i = 0; i < count; ++i) {
+        if (runs[i].load(std::memory_order_relaxed) != 1) wrong++;
+    }
+    return wrong;
+}
+
+static void mark_range(void* data, int begin, int end) {
+    (void)data;
+    for (int i = begin; i < end; ++i) {
+        runs[i].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ##################################################################
+//                          Nested Submits
+// ##################################################################
+
+static JobSystem* nested_system;
+
+// Level 1: splits its range into children (on this worker's deque) and waits on them;
+// half of the children split once more, so the tree is three levels deep
+static void nested_job(void* data, int begin, int end) {
+    int depth = (int)(intptr_t)data;
+    if (depth == 0 || end - begin <= 16) {
+        mark_range(0, begin, end);
+        return;
+    }
+
+    JobCounter children;
+    int step = (end - begin + 7) / 8;
+    for (int child = begin; child < end; child += step) {
+        int child_end = child + step < end ? child + step : end;
+        void* child_depth = (void*)(intptr_t)(((child / step) & 1) ? depth - 1 : 0);
+        job_submit(nested_system, nested_job, child_depth, child, child_end, &children);
+    }
+    job_wait(nested_system, &children);
+}
+
+static void test_nested_submits(JobSystem* system) {
+    nested_system = system;
+    for (int round = 0; round < 20; ++round) {
+        reset_runs();
+        JobCounter counter;
+        int step = TEST_INDEX_COUNT / 64;
+        for (int begin = 0; begin < TEST_INDEX_COUNT; begin += step) {
+            job_submit(system, nested_job, (void*)(intptr_t)2, begin, begin + step, &counter);
+        }
+        job_wait(system, &counter);
+
+        int wrong = count_wrong_runs(TEST_INDEX_COUNT);
+        TEST_CHECK_MESSAGE(wrong == 0, "nested round %d: %d indices did not run exactly once", round, wrong);
+        if (wrong) break;
+    }
+}
+
+// ##################################################################
+//                          Last-Item Races
+// ##################################################################
+
+static void test_last_item_races(JobSystem* system) {
+    // 1 or 2 jobs per round: job_wait pops the last one while idle workers steal from the top
+    reset_runs();
+    int index = 0;
+    for (int round = 0; round < 20000 && index + 2 <= TEST_INDEX_COUNT; ++round) {
+        JobCounter counter;
+        int jobs = 1 + (round & 1);
+        for (int j = 0; j < jobs; ++j) {
+            job_submit(system, mark_range, 0, index, index + 1, &counter);
+            index++;
+        }
+        job_wait(system, &counter);
+    }
+
+    int wrong = count_wrong_runs(index);
+    TEST_CHECK_MESSAGE(wrong == 0, "last-item races: %d of %d indices did not run exactly once", wrong, index);
+    TEST_CHECK(system->pending_jobs.load() == 0);
+}
+
+// ##################################################################
+//                          Sleep / Wake
+// ##################################################################
+
+// Waits until every worker sleeps. Returns false after timeout_seconds.
+static bool wait_for_sleepers(JobSystem* system, double timeout_seconds) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (system->sleeping_workers.load() < system->thread_count - 1) {
+        if (seconds_since(start) > timeout_seconds) return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return true;
+}
+
+static void test_sleep_wake(JobSystem* system) {
+    if (system->thread_count < 2) return;
+
+    reset_runs();
+    int index = 0;
+    for (int round = 0; round < 100; ++round) {
+        bool asleep = wait_for_sleepers(system, 5.0);
+        TEST_CHECK_MESSAGE(asleep, "round %d: workers did not go to sleep on an empty system", round);
+        if (!asleep) return;
+
+        // Burst of jobs; the main thread only watches the counter, so only woken workers can finish them
+        JobCounter counter;
+        int jobs = 1 + round % 8;
+        for (int j = 0; j < jobs; ++j) {
+            job_submit(system, mark_range, 0, index, index + 1, &counter);
+            index++;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (counter.value.load(std::memory_order_acquire) > 0 && seconds_since(start) < 5.0) {
+            std::this_thread::yield();
+        }
+        bool woke = counter.value.load() == 0;
+        TEST_CHECK_MESSAGE(woke, "round %d: %d jobs never picked up by a sleeping worker", round, counter.value.load());
+        if (!woke) {
+            job_wait(system, &counter); // Finish them here so the system can shut down
+            return;
+        }
+    }
+
+    int wrong = count_wrong_runs(index);
+    TEST_CHECK_MESSAGE(wrong == 0, "sleep/wake: %d indices did not run exactly once", wrong);
+}
+
+int main() {
+    static const int thread_counts[] = { 2, 4, 8 };
+
+    for (int t = 0; t < (int)(sizeof(thread_counts) / sizeof(thread_counts[0])); ++t) {
+        static JobSystem system;
+        job_system_init(&system, thread_counts[t]);
+        printf("%d threads\n", system.thread_count);
+
+        test_nested_submits(&system);
+        test_last_item_races(&system);
+        test_sleep_wake(&system);
+
+        uint64_t stolen = 0;
+        for (int i = 0; i < system.thread_count; ++i) stolen += system.deques[i]->jobs_stolen.load();
+        printf("  %llu jobs stolen\n", (unsigned long long)stolen);
+
+        job_system_shutdown(&system);
+    }
+    return test_report("job_system_test");
+}
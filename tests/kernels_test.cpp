@@ -0,0 +1,294 @@
+// Kernel dispatch table: every level the CPU supports must match the scalar kernels.
+//   - Pixel, asset-conversion, particle and edge kernels: bit-identical output, on random sizes
+//     (including tails shorter than a SIMD register), unaligned starts and padded pitches.
+//     Whole buffers are compared, so writes outside the requested rectangle are caught too.
+//   - write_sound_samples: the SIMD versions use a polynomial sine for the test tone, so samples
+//     may differ from sinf by a rounding step; the mixed voices must match exactly.
+
+#include "kernels.h"
+#include "test.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_ITERATIONS 3000
+
+// Pixel buffers: room for a 96 x 6 rectangle at any offset with any pitch below
+#define TEST_PIXEL_COUNT 2048
+
+static uint32_t random_state = 0x6C078965u;
+
+static uint32_t next_random() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// Colors with the alpha values the kernels treat specially (0, 255) over-represented
+static uint32_t random_pixel() {
+    uint32_t color = next_random();
+    switch (next_random() % 4) {
+        case 0: return color | 0xFF000000;
+        case 1: return color & 0x00FFFFFF;
+        default: return color;
+    }
+}
+
+static float random_float(float min, float max) {
+    return min + (max - min) * (float)(next_random() & 0xFFFFFF) / 16777216.0f;
+}
+
+static uint32_t source_pixels[TEST_PIXEL_COUNT];
+static uint32_t expected_pixels[TEST_PIXEL_COUNT];
+static uint32_t actual_pixels[TEST_PIXEL_COUNT];
+
+// Random rectangle: width up to 96 (covers 1..6 AVX-512 registers plus any tail), small heights
+struct TestRect {
+    int offset;         // Start, in pixels (any alignment)
+    int width;
+    int height;
+    int pitch;          // In pixels
+};
+
+static TestRect random_rect() {
+    TestRect rect;
+    rect.width = 1 + (int)(next_random() % 96);
+    rect.height = 1 + (int)(next_random() % 6);
+    rect.pitch = rect.width + (int)(next_random() % 8);
+    rect.offset = (int)(next_random() % 32);
+    return rect;
+}
+
+static void randomize_pixels() {
+    for (int i = 0; i < TEST_PIXEL_COUNT; ++i) {
+        source_pixels[i] = random_pixel();
+        expected_pixels[i] = random_pixel();
+    }
+    memcpy(actual_pixels, expected_pixels, sizeof(actual_pixels));
+}
+
+// ##################################################################
+//                          Pixel Kernels
+// ##################################################################
+
+static void test_pixel_kernels(const EngineKernels* scalar, const EngineKernels* simd) {
+    const char* name = cpu_isa_name(simd->isa);
+    int failures[5] = {};
+
+    for (int iteration = 0; iteration < TEST_ITERATIONS; ++iteration) {
+        TestRect rect = random_rect();
+        TestRect from = random_rect();
+        from.width = rect.width;
+        from.height = rect.height;
+        from.pitch = rect.width + (int)(next_random() % 8);
+        uint32_t color = random_pixel();
+
+        uint8_t* expected = (uint8_t*)(expected_pixels + rect.offset);
+        uint8_t* actual = (uint8_t*)(actual_pixels + rect.offset);
+        const uint32_t* source = source_pixels + from.offset;
+        int pitch = rect.pitch * 4;
+
+        randomize_pixels();
+        scalar->fill_pixels(expected, pitch, rect.width, rect.height, color);
+        simd->fill_pixels(actual, pitch, rect.width, rect.height, color);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) failures[0]++;
+
+        randomize_pixels();
+        scalar->copy_pixels(expected, pitch, source, from.pitch, rect.width, rect.height);
+        simd->copy_pixels(actual, pitch, source, from.pitch, rect.width, rect.height);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) failures[1]++;
+
+        randomize_pixels();
+        scalar->blend_pixels(expected, pitch, source, from.pitch, rect.width, rect.height);
+        simd->blend_pixels(actual, pitch, source, from.pitch, rect.width, rect.height);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) failures[2]++;
+
+        randomize_pixels();
+        scalar->add_pixels(expected, pitch, source, from.pitch, rect.width, rect.height);
+        simd->add_pixels(actual, pitch, source, from.pitch, rect.width, rect.height);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) failures[3]++;
+
+        // Edge functions as the rasterizer passes them: a zero edge always passes
+        RasterEdges edges;
+        int size_x = 1 + (int)(next_random() % RASTER_BLOCK_SIZE);
+        int size_y = 1 + (int)(next_random() % RASTER_BLOCK_SIZE);
+        for (int k = 0; k < 3; ++k) {
+            bool zero = next_random() % 4 == 0;
+            edges.step_x[k] = zero ? 0 : (int32_t)(next_random() % 8193) - 4096;
+            edges.step_y[k] = zero ? 0 : (int32_t)(next_random() % 8193) - 4096;
+            edges.origin[k] = zero ? 0 : (int32_t)(next_random() % 65537) - 32768;
+        }
+        randomize_pixels();
+        scalar->fill_edges(expected, pitch, size_x, size_y, &edges, color);
+        simd->fill_edges(actual, pitch, size_x, size_y, &edges, color);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) failures[4]++;
+    }
+
+    static const char* kernel_names[5] = { "fill_pixels", "copy_pixels", "blend_pixels", "add_pixels", "fill_edges" };
+    for (int k = 0; k < 5; ++k) {
+        TEST_CHECK_MESSAGE(failures[k] == 0, "%s %s: %d of %d cases differ from scalar",
+                           name, kernel_names[k], failures[k], TEST_ITERATIONS);
+    }
+}
+
+// ##################################################################
+//                          Asset Conversion
+// ##################################################################
+
+static void test_conversion_kernels(const EngineKernels* scalar, const EngineKernels* simd) {
+    static uint8_t file_bytes[4 * 300 + 8];
+    int premultiply_failures = 0;
+    int expand_failures = 0;
+    int expand_bgrx_failures = 0;
+
+    for (int iteration = 0; iteration < TEST_ITERATIONS; ++iteration) {
+        int count = (int)(next_random() % 257);
+        int source_offset = (int)(next_random() % 8);   // File rows start at any byte
+        int dest_offset = (int)(next_random() % 16);
+        for (int i = 0; i < (int)sizeof(file_bytes); ++i) file_bytes[i] = (uint8_t)random_pixel();
+
+        // 4th bytes all zero (BI_RGB without alpha), except sometimes one at a random pixel
+        for (int i = source_offset + 3; i < (int)sizeof(file_bytes); i += 4) file_bytes[i] = 0;
+        if (count > 0 && next_random() % 2) {
+            file_bytes[source_offset + 4 * (int)(next_random() % count) + 3] = (uint8_t)(1 + next_random() % 255);
+        }
+        randomize_pixels();
+        bool scalar_any = scalar->expand_bgrx_pixels(expected_pixels + dest_offset, file_bytes + source_offset, count);
+        bool simd_any = simd->expand_bgrx_pixels(actual_pixels + dest_offset, file_bytes + source_offset, count);
+        if (scalar_any != simd_any || memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) {
+            expand_bgrx_failures++;
+        }
+        for (int i = 0; i < (int)sizeof(file_bytes); ++i) file_bytes[i] = (uint8_t)random_pixel();
+
+        randomize_pixels();
+        scalar->premultiply_pixels(expected_pixels + dest_offset, file_bytes + source_offset, count);
+        simd->premultiply_pixels(actual_pixels + dest_offset, file_bytes + source_offset, count);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) premultiply_failures++;
+
+        randomize_pixels();
+        scalar->expand_bgr_pixels(expected_pixels + dest_offset, file_bytes + source_offset, count);
+        simd->expand_bgr_pixels(actual_pixels + dest_offset, file_bytes + source_offset, count);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) expand_failures++;
+    }
+
+    // In place (how the BMP decoder premultiplies 32-bit rows)
+    for (int iteration = 0; iteration < TEST_ITERATIONS; ++iteration) {
+        int count = (int)(next_random() % 257);
+        randomize_pixels();
+        memcpy(actual_pixels, expected_pixels, sizeof(actual_pixels));
+        scalar->premultiply_pixels(expected_pixels, (const uint8_t*)expected_pixels, count);
+        simd->premultiply_pixels(actual_pixels, (const uint8_t*)actual_pixels, count);
+        if (memcmp(expected_pixels, actual_pixels, sizeof(actual_pixels))) premultiply_failures++;
+    }
+
+    TEST_CHECK_MESSAGE(premultiply_failures == 0, "%s premultiply_pixels: %d cases differ from scalar",
+                       cpu_isa_name(simd->isa), premultiply_failures);
+    TEST_CHECK_MESSAGE(expand_failures == 0, "%s expand_bgr_pixels: %d cases differ from scalar",
+                       cpu_isa_name(simd->isa), expand_failures);
+    TEST_CHECK_MESSAGE(expand_bgrx_failures == 0, "%s expand_bgrx_pixels: %d cases differ from scalar",
+                       cpu_isa_name(simd->isa), expand_bgrx_failures);
+}
+
+// ##################################################################
+//                          Particles and Audio
+// ##################################################################
+
+#define TEST_PARTICLES 300
+
+static void test_particle_kernel(const EngineKernels* scalar, const EngineKernels* simd) {
+    static float expected[5][TEST_PARTICLES + 16];
+    static float actual[5][TEST_PARTICLES + 16];
+    int failures = 0;
+
+    for (int iteration = 0; iteration < TEST_ITERATIONS; ++iteration) {
+        int count = (int)(next_random() % (TEST_PARTICLES + 1));
+        int offset = (int)(next_random() % 16);        // Pools are aligned, but the tail logic is not
+        float dt = random_float(0.001f, 0.05f);
+        float gravity = random_float(-3000.0f, 3000.0f);
+        for (int a = 0; a < 5; ++a) {
+            for (int i = 0; i < TEST_PARTICLES + 16; ++i) expected[a][i] = random_float(-2000.0f, 2000.0f);
+        }
+        memcpy(actual, expected, sizeof(actual));
+
+        scalar->update_particles(expected[0] + offset, expected[1] + offset, expected[2] + offset,
+                                 expected[3] + offset, expected[4] + offset, count, dt, gravity);
+        simd->update_particles(actual[0] + offset, actual[1] + offset, actual[2] + offset,
+                               actual[3] + offset, actual[4] + offset, count, dt, gravity);
+        if (memcmp(expected, actual, sizeof(actual))) failures++;
+    }
+    TEST_CHECK_MESSAGE(failures == 0, "%s update_particles: %d cases differ from scalar",
+                       cpu_isa_name(simd->isa), failures);
+}
+
+#define TEST_FRAMES 600
+
+static void test_sound_kernel(const EngineKernels* scalar, const EngineKernels* simd) {
+    static float mix_left[TEST_FRAMES];
+    static float mix_right[TEST_FRAMES];
+    static int16_t expected[2 * TEST_FRAMES + 8];
+    static int16_t actual[2 * TEST_FRAMES + 8];
+    int worst_tone = 0;
+    int mix_failures = 0;
+    int overruns = 0;
+    float worst_phase = 0.0f;
+
+    for (int iteration = 0; iteration < 500; ++iteration) {
+        uint32_t count = next_random() % (TEST_FRAMES + 1);
+        for (uint32_t i = 0; i < TEST_FRAMES; ++i) {
+            mix_left[i] = random_float(-1.2f, 1.2f);   // Past full scale: saturation is tested too
+            mix_right[i] = random_float(-1.2f, 1.2f);
+        }
+        float phase_step = random_float(0.0f, 0.2f);
+        float start_phase = random_float(0.0f, 6.28f);
+        memset(expected, 0x55, sizeof(expected));
+        memset(actual, 0x55, sizeof(actual));
+
+        // Tone off: only the mixed voices, which must match exactly
+        float expected_phase = start_phase;
+        float actual_phase = start_phase;
+        scalar->write_sound_samples(expected, mix_left, mix_right, count, &expected_phase, phase_step, 0.0f);
+        simd->write_sound_samples(actual, mix_left, mix_right, count, &actual_phase, phase_step, 0.0f);
+        if (memcmp(expected, actual, sizeof(actual))) mix_failures++;
+
+        // Tone on: within a few steps of the scalar sinf, and nothing written past the end
+        expected_phase = start_phase;
+        actual_phase = start_phase;
+        scalar->write_sound_samples(expected, mix_left, mix_right, count, &expected_phase, phase_step, 3000.0f);
+        simd->write_sound_samples(actual, mix_left, mix_right, count, &actual_phase, phase_step, 3000.0f);
+        for (uint32_t i = 0; i < 2 * count; ++i) {
+            int difference = abs((int)expected[i] - (int)actual[i]);
+            if (difference > worst_tone) worst_tone = difference;
+        }
+        if (memcmp(expected + 2 * count, actual + 2 * count, sizeof(actual) - 4 * count)) overruns++;
+        float phase_difference = fabsf(expected_phase - actual_phase);
+        if (phase_difference > 3.14159265f) phase_difference = 6.28318531f - phase_difference;   // Across the wrap
+        if (phase_difference > worst_phase) worst_phase = phase_difference;
+    }
+
+    const char* name = cpu_isa_name(simd->isa);
+    TEST_CHECK_MESSAGE(mix_failures == 0, "%s write_sound_samples: %d mixes differ from scalar", name, mix_failures);
+    TEST_CHECK_MESSAGE(overruns == 0, "%s write_sound_samples: %d calls wrote past the end", name, overruns);
+    TEST_CHECK_MESSAGE(worst_tone <= 2, "%s write_sound_samples: tone off by %d steps", name, worst_tone);
+    TEST_CHECK_MESSAGE(worst_phase < 1e-3f, "%s write_sound_samples: phase off by %g", name, worst_phase);
+    printf("%s write_sound_samples: tone within %d steps of sinf\n", name, worst_tone);
+}
+
+int main() {
+    CpuIsa best = cpu_best_isa(detect_cpu_features());
+    printf("best level on this machine: %s\n", cpu_isa_name(best));
+
+    EngineKernels scalar;
+    kernels_build_table(&scalar, CPU_ISA_SCALAR);
+
+    for (int level = CPU_ISA_SCALAR + 1; level <= best; ++level) {
+        EngineKernels simd;
+        kernels_build_table(&simd, (CpuIsa)level);
+        test_pixel_kernels(&scalar, &simd);
+        test_conversion_kernels(&scalar, &simd);
+        test_particle_kernel(&scalar, &simd);
+        test_sound_kernel(&scalar, &simd);
+    }
+    return test_report("kernels_test");
+}
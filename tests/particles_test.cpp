@@ -0,0 +1,171 @@
+// Particle pools:
+//   - particles_update swap-removes the dead: afterwards [0, count) holds exactly the particles that
+//     were still alive, each once, for random death patterns (runs of neighbours dying in the same
+//     tick, the last particle dying, everything dying) and counts that leave a SIMD tail.
+//   - particles_render places sprites at floor(position - camera): particles partly off the
+//     left/top edge are drawn a pixel further out, not pulled a pixel inwards.
+
+#include "particles.h"
+#include "test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t random_state = 0x2545F491u;
+
+static uint32_t next_random() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// ##################################################################
+//                          Swap-Remove
+// ##################################################################
+
+#define TEST_PARTICLE_COUNT 1000
+#define TEST_DT (1.0f / 60.0f)
+
+static bool alive[TEST_PARTICLE_COUNT];
+static int seen[TEST_PARTICLE_COUNT];
+
+// Fills the pool with count particles; particle id keeps pos_x == id (no velocity, no gravity)
+// and dies this tick when alive[id] is false
+static void fill_pool(ParticlePool* pool, int count) {
+    for (int id = 0; id < count; ++id) {
+        pool->pos_x[id] = (float)id;
+        pool->pos_y[id] = (float)id;
+        pool->vel_x[id] = 0.0f;
+        pool->vel_y[id] = 0.0f;
+        pool->life[id] = alive[id] ? 1.0f : 0.5f * TEST_DT;
+        pool->inv_lifetime[id] = 1.0f;
+    }
+    pool->count = count;
+}
+
+// Checks that [0, count) holds every live particle once and nothing else
+static bool check_survivors(ParticlePool* pool, int count, const char* pattern) {
+    int expected = 0;
+    for (int id = 0; id < count; ++id) {
+        expected += alive[id];
+        seen[id] = 0;
+    }
+    if (!TEST_CHECK_MESSAGE(pool->count == expected, "%s: %d particles left, expected %d",
+                            pattern, pool->count, expected)) {
+        return false;
+    }
+
+    for (int i = 0; i < pool->count; ++i) {
+        int id = (int)pool->pos_x[i];
+        bool valid = id >= 0 && id < count && pool->pos_y[i] == (float)id && pool->life[i] > 0.0f;
+        if (!TEST_CHECK_MESSAGE(valid && alive[id] && seen[id] == 0,
+                                "%s: slot %d holds particle %d (dead or repeated)", pattern, i, id)) {
+            return false;
+        }
+        seen[id]++;
+    }
+    return true;
+}
+
+static void test_swap_remove() {
+    ParticlePool pool;
+    TEST_CHECK(particles_init(&pool, 4, 0xFFA040, PARTICLE_BLEND_ADDITIVE));
+
+    // Fixed patterns: neighbours dying together at the start, middle and end, and everything dying
+    static const char* patterns[] = {
+        "..XXXX..X.XX...X",
+        "XXXX............",
+        "............XXXX",
+        "X.X.X.X.X.X.X.X.",
+        ".XXXXXXXXXXXXXXX",
+        "XXXXXXXXXXXXXXX.",
+        "XXXXXXXXXXXXXXXX",
+        "................",
+    };
+    for (int p = 0; p < (int)(sizeof(patterns) / sizeof(patterns[0])); ++p) {
+        int count = (int)strlen(patterns[p]);
+        for (int id = 0; id < count; ++id) alive[id] = patterns[p][id] != 'X';
+        fill_pool(&pool, count);
+        particles_update(&pool, TEST_DT, 0.0f);
+        check_survivors(&pool, count, patterns[p]);
+    }
+
+    // Random patterns: runs of deaths of random length, any count
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        int count = (int)(next_random() % TEST_PARTICLE_COUNT);
+        int death_rate = (int)(next_random() % 101);
+        for (int id = 0; id < count;) {
+            bool dies = (int)(next_random() % 100) < death_rate;
+            int run = 1 + (int)(next_random() % 8);
+            for (int k = 0; k < run && id < count; ++k) alive[id++] = !dies;
+        }
+        fill_pool(&pool, count);
+        particles_update(&pool, TEST_DT, 0.0f);
+        if (!check_survivors(&pool, count, "random")) break;
+    }
+
+    particles_free(&pool);
+}
+
+// ##################################################################
+//                          Rendering
+// ##################################################################
+
+#define TEST_SCREEN_SIZE 16
+
+static uint32_t screen_pixels[TEST_SCREEN_SIZE * TEST_SCREEN_SIZE];
+
+// Renders one additive particle onto a black screen and compares every pixel with the sprite
+// placed at (expected_x, expected_y)
+static void check_render(ParticlePool* pool, float x, float y, int expected_x, int expected_y) {
+    GameBuffer buffer = { screen_pixels, TEST_SCREEN_SIZE, TEST_SCREEN_SIZE, TEST_SCREEN_SIZE * 4 };
+    memset(screen_pixels, 0, sizeof(screen_pixels));
+
+    // Camera at (10, 20): the particle is at (x, y) on screen
+    pool->pos_x[0] = x + 10.0f;
+    pool->pos_y[0] = y + 20.0f;
+    pool->vel_x[0] = 0.0f;
+    pool->vel_y[0] = 0.0f;
+    pool->life[0] = 1.0f;
+    pool->inv_lifetime[0] = 1.0f;
+    pool->count = 1;
+    int drawn = particles_render(&buffer, pool, 10.0f, 20.0f);
+    TEST_CHECK_MESSAGE(drawn == 1, "particle at (%g, %g): %d drawn", x, y, drawn);
+
+    int size = pool->sprite_size;
+    int mismatches = 0;
+    for (int py = 0; py < TEST_SCREEN_SIZE; ++py) {
+        for (int px = 0; px < TEST_SCREEN_SIZE; ++px) {
+            int sx = px - expected_x;
+            int sy = py - expected_y;
+            uint32_t expected = 0;
+            if (sx >= 0 && sx < size && sy >= 0 && sy < size) {
+                expected = pool->sprite.pixels[sy * pool->sprite.width + sx] & 0x00FFFFFF;   // Frame 0
+            }
+            if (screen_pixels[py * TEST_SCREEN_SIZE + px] != expected) mismatches++;
+        }
+    }
+    TEST_CHECK_MESSAGE(mismatches == 0, "particle at (%g, %g): %d pixels differ from the sprite at (%d, %d)",
+                       x, y, mismatches, expected_x, expected_y);
+}
+
+static void test_render_position() {
+    ParticlePool pool;
+    TEST_CHECK(particles_init(&pool, 6, 0xFFFFFF, PARTICLE_BLEND_ADDITIVE));
+
+    check_render(&pool, 3.0f, 4.0f, 3, 4);
+    check_render(&pool, 3.75f, 4.5f, 3, 4);
+    check_render(&pool, -0.5f, 2.0f, -1, 2);
+    check_render(&pool, 2.0f, -2.25f, 2, -3);
+    check_render(&pool, -4.75f, -0.01f, -5, -1);
+    check_render(&pool, 12.5f, 13.9f, 12, 13);
+
+    particles_free(&pool);
+}
+
+int main() {
+    test_swap_remove();
+    test_render_position();
+    return test_report("particles_test");
+}
@@ -0,0 +1,248 @@
+// Triangle rasterizer:
+//   - Watertight meshes: a jittered grid and triangle fans (one cut to the guard band) that cover
+//     the whole buffer write every pixel exactly once (top-left rule on every shared edge).
+//   - Coverage: pixel centers clearly inside a triangle are drawn, centers clearly outside are not,
+//     including triangles reaching far past RASTER_GUARD_BAND.
+//   - Every kernel level the CPU supports draws the same pixels as the scalar kernels.
+
+#include "render.h"
+#include "kernels.h"
+#include "test.h"
+
+#include <math.h>
+#include <string.h>
+
+// Odd size and a pitch wider than the rows, so partial blocks and row steps are exercised
+#define TEST_WIDTH 333
+#define TEST_HEIGHT 217
+#define TEST_PITCH_PIXELS (TEST_WIDTH + 7)
+
+static uint32_t pixels[TEST_HEIGHT * TEST_PITCH_PIXELS];
+static uint8_t coverage[TEST_HEIGHT * TEST_WIDTH];
+
+static GameBuffer test_buffer() {
+    GameBuffer buffer = { pixels, TEST_WIDTH, TEST_HEIGHT, TEST_PITCH_PIXELS * 4 };
+    return buffer;
+}
+
+static uint32_t random_state = 0x2545F491u;
+
+static uint32_t next_random() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// Random value in [min, max): half of them on the 1/16 subpixel grid (often exactly on pixel centers)
+static float random_coordinate(float min, float max) {
+    float t = (float)(next_random() & 0xFFFFFF) / 16777216.0f;
+    float value = min + t * (max - min);
+    if (next_random() & 1) value = floorf(value * 2.0f + 0.5f) * 0.5f;
+    return value;
+}
+
+// Draws one triangle on a cleared buffer and adds it to the coverage counts.
+// Also checks that nothing was written to the padding between rows.
+static void add_coverage(float x0, float y0, float x1, float y1, float x2, float y2) {
+    GameBuffer buffer = test_buffer();
+    memset(pixels, 0, sizeof(pixels));
+    draw_triangle(&buffer, x0, y0, x1, y1, x2, y2, 0xFFFFFFFF);
+
+    bool padding_clean = true;
+    for (int y = 0; y < TEST_HEIGHT; ++y) {
+        for (int x = 0; x < TEST_PITCH_PIXELS; ++x) {
+            uint32_t pixel = pixels[y * TEST_PITCH_PIXELS + x];
+            if (x >= TEST_WIDTH) {
+                padding_clean = padding_clean && pixel == 0;
+            } else if (pixel) {
+                coverage[y * TEST_WIDTH + x]++;
+            }
+        }
+    }
+    TEST_CHECK(padding_clean);
+}
+
+static void check_coverage_is_one(const char* mesh) {
+    int missing = 0;
+    int doubled = 0;
+    for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT; ++i) {
+        if (coverage[i] == 0) missing++;
+        if (coverage[i] > 1) doubled++;
+    }
+    TEST_CHECK_MESSAGE(missing == 0 && doubled == 0, "%s: %d pixels not drawn, %d drawn more than once",
+                       mesh, missing, doubled);
+}
+
+// ##################################################################
+//                          Watertight Meshes
+// ##################################################################
+
+static void test_grid_mesh() {
+    // Vertices of a grid reaching past the buffer on every side, all but the outer ring jittered
+    const int columns = 12;
+    const int rows = 9;
+    float vx[rows + 1][columns + 1];
+    float vy[rows + 1][columns + 1];
+    for (int r = 0; r <= rows; ++r) {
+        for (int c = 0; c <= columns; ++c) {
+            vx[r][c] = -20.0f + (float)c * (TEST_WIDTH + 40.0f) / columns;
+            vy[r][c] = -20.0f + (float)r * (TEST_HEIGHT + 40.0f) / rows;
+            if (r > 0 && r < rows && c > 0 && c < columns) {
+                vx[r][c] += random_coordinate(-8.0f, 8.0f);
+                vy[r][c] += random_coordinate(-8.0f, 8.0f);
+            }
+        }
+    }
+
+    memset(coverage, 0, sizeof(coverage));
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < columns; ++c) {
+            // Alternate the diagonal, and the winding, from quad to quad
+            if ((r + c) & 1) {
+                add_coverage(vx[r][c], vy[r][c], vx[r][c + 1], vy[r][c + 1], vx[r + 1][c + 1], vy[r + 1][c + 1]);
+                add_coverage(vx[r][c], vy[r][c], vx[r + 1][c], vy[r + 1][c], vx[r + 1][c + 1], vy[r + 1][c + 1]);
+            } else {
+                add_coverage(vx[r][c + 1], vy[r][c + 1], vx[r][c], vy[r][c], vx[r + 1][c], vy[r + 1][c]);
+                add_coverage(vx[r][c + 1], vy[r][c + 1], vx[r + 1][c], vy[r + 1][c], vx[r + 1][c + 1], vy[r + 1][c + 1]);
+            }
+        }
+    }
+    check_coverage_is_one("jittered grid");
+}
+
+// Fan around a point of the buffer, out to a polygon that contains the whole buffer
+static void test_fan(const char* name, float center_x, float center_y, float radius, int spokes) {
+    const float two_pi = 6.28318530717958647692f;
+    memset(coverage, 0, sizeof(coverage));
+    for (int i = 0; i < spokes; ++i) {
+        float a0 = two_pi * (float)i / (float)spokes;
+        float a1 = two_pi * (float)(i + 1) / (float)spokes;
+        if (i + 1 == spokes) a1 = 0.0f;     // Same last vertex as the first spoke
+        add_coverage(center_x, center_y,
+                     center_x + radius * cosf(a0), center_y + radius * sinf(a0),
+                     center_x + radius * cosf(a1), center_y + radius * sinf(a1));
+    }
+    check_coverage_is_one(name);
+}
+
+// ##################################################################
+//                          Coverage
+// ##################################################################
+
+// Compares a drawn triangle with the exact one: centers further than margin pixels inside every edge
+// must be drawn, centers further than margin outside any edge must not
+static void check_triangle_coverage(float x0, float y0, float x1, float y1, float x2, float y2, double margin) {
+    memset(coverage, 0, sizeof(coverage));
+    add_coverage(x0, y0, x1, y1, x2, y2);
+
+    double px[3] = { x0, x1, x2 };
+    double py[3] = { y0, y1, y2 };
+    double area2 = (px[1] - px[0]) * (py[2] - py[0]) - (py[1] - py[0]) * (px[2] - px[0]);
+    if (area2 == 0.0) return;
+    double winding = area2 > 0.0 ? 1.0 : -1.0;
+
+    int wrong = 0;
+    for (int y = 0; y < TEST_HEIGHT; ++y) {
+        for (int x = 0; x < TEST_WIDTH; ++x) {
+            double cx = x + 0.5, cy = y + 0.5;
+            double nearest = 1e300;
+            for (int k = 0; k < 3; ++k) {
+                int n = (k + 1) % 3;
+                double ex = px[n] - px[k], ey = py[n] - py[k];
+                double distance = winding * ((cy - py[k]) * ex - (cx - px[k]) * ey) / sqrt(ex * ex + ey * ey);
+                nearest = distance < nearest ? distance : nearest;
+            }
+            // nearest > 0: inside, by that many pixels from the closest edge
+            bool drawn = coverage[y * TEST_WIDTH + x] != 0;
+            if (nearest > margin && !drawn) wrong++;
+            if (nearest < -margin && drawn) wrong++;
+        }
+    }
+    TEST_CHECK_MESSAGE(wrong == 0, "triangle (%g,%g) (%g,%g) (%g,%g): %d pixels wrong", x0, y0, x1, y1, x2, y2, wrong);
+}
+
+static void test_coverage() {
+    // Reaches past the guard band on the left, most of it is on screen
+    check_triangle_coverage(-20000.0f, 0.0f, 100.0f, 0.0f, 100.0f, 100.0f, 0.1);
+    check_triangle_coverage(-1.0e9f, -1.0e9f, 300.0f, 10.0f, 10.0f, 200.0f, 0.1);
+    check_triangle_coverage(50.0f, 1.0e7f, 60.0f, -3.0e6f, 320.0f, 100.0f, 0.1);
+
+    for (int i = 0; i < 300; ++i) {
+        float range = (i % 3 == 0) ? 40000.0f : 400.0f;
+        check_triangle_coverage(random_coordinate(-range, range), random_coordinate(-range, range),
+                                random_coordinate(-range, range), random_coordinate(-range, range),
+                                random_coordinate(-range, range), random_coordinate(-range, range), 0.1);
+    }
+
+    // Entirely outside the guard band, or not finite: nothing is drawn
+    float nan = sqrtf(-1.0f);
+    float outside[][6] = {
+        { -50000.0f, -50000.0f, -40000.0f, -50000.0f, -40000.0f, -40000.0f },
+        { nan, 10.0f, 100.0f, 10.0f, 100.0f, 100.0f },
+        { 10.0f, 10.0f, INFINITY, 10.0f, 100.0f, 100.0f },
+    };
+    for (int i = 0; i < 3; ++i) {
+        memset(coverage, 0, sizeof(coverage));
+        add_coverage(outside[i][0], outside[i][1], outside[i][2], outside[i][3], outside[i][4], outside[i][5]);
+        int drawn = 0;
+        for (int p = 0; p < TEST_WIDTH * TEST_HEIGHT; ++p) drawn += coverage[p];
+        TEST_CHECK_MESSAGE(drawn == 0, "triangle %d outside the guard band drew %d pixels", i, drawn);
+    }
+}
+
+// ##################################################################
+//                          Kernel Levels
+// ##################################################################
+
+static uint32_t scalar_frame[TEST_HEIGHT * TEST_PITCH_PIXELS];
+
+// Random triangles and lines in random colors, over a patterned background
+static void draw_random_scene(uint32_t seed) {
+    GameBuffer buffer = test_buffer();
+    for (int i = 0; i < TEST_HEIGHT * TEST_PITCH_PIXELS; ++i) pixels[i] = (uint32_t)i * 2654435761u;
+
+    random_state = seed;
+    for (int i = 0; i < 400; ++i) {
+        float range = (i % 8 == 0) ? 30000.0f : 500.0f;
+        uint32_t color = next_random();
+        if (i % 4 == 3) {
+            draw_line(&buffer, random_coordinate(-range, range), random_coordinate(-range, range),
+                      random_coordinate(-range, range), random_coordinate(-range, range),
+                      random_coordinate(0.5f, 20.0f), color);
+        } else {
+            draw_triangle(&buffer, random_coordinate(-range, range), random_coordinate(-range, range),
+                          random_coordinate(-range, range), random_coordinate(-range, range),
+                          random_coordinate(-range, range), random_coordinate(-range, range), color);
+        }
+    }
+}
+
+static void test_kernel_levels() {
+    CpuIsa best = cpu_best_isa(detect_cpu_features());
+
+    kernels_init(CPU_ISA_SCALAR);
+    draw_random_scene(1234);
+    memcpy(scalar_frame, pixels, sizeof(pixels));
+
+    for (int level = CPU_ISA_SCALAR + 1; level <= best; ++level) {
+        CpuIsa bound = kernels_init((CpuIsa)level);
+        TEST_CHECK(bound == (CpuIsa)level);
+        draw_random_scene(1234);
+        TEST_CHECK_MESSAGE(memcmp(scalar_frame, pixels, sizeof(pixels)) == 0,
+                           "%s triangles differ from scalar", cpu_isa_name((CpuIsa)level));
+        printf("%s: same frame as scalar\n", cpu_isa_name((CpuIsa)level));
+    }
+}
+
+int main() {
+    // The mesh tests run with the best kernels (what the game uses)
+    kernels_init(cpu_best_isa(detect_cpu_features()));
+
+    test_grid_mesh();
+    test_fan("fan", 161.3f, 108.7f, 400.0f, 37);
+    test_fan("fan cut to the guard band", 20.25f, 200.5f, 60000.0f, 23);
+    test_coverage();
+    test_kernel_levels();
+    return test_report("raster_test");
+}
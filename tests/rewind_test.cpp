@@ -0,0 +1,177 @@
+// Rewind history round trips:
+//   - Record N ticks of images that change in size and content, step back K, and compare every
+//     restored image byte-for-byte with a saved copy (history held whole, and a small ring that
+//     drops old ticks and wraps around).
+//   - Delta encoding of random image pairs: applying the delta turns the newer image into the older.
+//   - Particle save/load through the block layout, for counts that do not fill the last block.
+
+#include "particles.h"
+#include "rewind.h"
+#include "test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_IMAGE_SIZE 6000
+#define TEST_TICKS 400
+
+static uint32_t random_state = 0x9E3779B9u;
+
+static uint32_t next_random() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// Saved copies of every recorded image
+static uint8_t saved_images[TEST_TICKS][TEST_IMAGE_SIZE];
+static size_t saved_sizes[TEST_TICKS];
+
+// Next image: the previous one with a few edited spans and a size that drifts (like the particle count)
+static void make_image(int tick) {
+    uint8_t* image = saved_images[tick];
+    size_t size = 1000 + next_random() % (TEST_IMAGE_SIZE - 1000);
+    if (tick > 0) {
+        size_t previous = saved_sizes[tick - 1];
+        size = previous + next_random() % 201 - 100;
+        if (size < 1000) size = 1000;
+        if (size > TEST_IMAGE_SIZE) size = TEST_IMAGE_SIZE;
+        memcpy(image, saved_images[tick - 1], previous < size ? previous : size);
+        for (size_t i = previous; i < size; ++i) image[i] = (uint8_t)next_random();
+    } else {
+        for (size_t i = 0; i < size; ++i) image[i] = (uint8_t)next_random();
+    }
+
+    // Every few ticks nothing changes at all (an empty delta)
+    int edits = (tick % 7 == 3) ? 0 : 1 + (int)(next_random() % 12);
+    for (int e = 0; e < edits; ++e) {
+        size_t start = next_random() % size;
+        size_t length = 1 + next_random() % 64;
+        for (size_t i = start; i < start + length && i < size; ++i) image[i] = (uint8_t)next_random();
+    }
+    saved_sizes[tick] = size;
+}
+
+static void record(RewindBuffer* rewind, int tick) {
+    memcpy(rewind_begin_snapshot(rewind), saved_images[tick], saved_sizes[tick]);
+    rewind_push(rewind, saved_sizes[tick], 1.0f / 60.0f);
+}
+
+// Steps back one tick at a time and checks each restored image against the copy saved for it
+static int step_back_and_compare(RewindBuffer* rewind, int newest_tick, int steps) {
+    int restored = 0;
+    for (int k = 1; k <= steps; ++k) {
+        size_t image_size;
+        const uint8_t* image = rewind_step_back(rewind, &image_size);
+        if (!image) break;
+
+        int tick = newest_tick - k;
+        bool same = tick >= 0 && image_size == saved_sizes[tick] && memcmp(image, saved_images[tick], image_size) == 0;
+        TEST_CHECK_MESSAGE(same, "step back %d: image of tick %d does not match", k, tick);
+        if (!same) break;
+        restored++;
+    }
+    return restored;
+}
+
+static void test_history_round_trip() {
+    for (int tick = 0; tick < TEST_TICKS; ++tick) make_image(tick);
+
+    // Whole history held: step back K, record again from there, step back to the start
+    RewindBuffer rewind;
+    TEST_CHECK(rewind_init(&rewind, 1u << 20, TEST_TICKS, TEST_IMAGE_SIZE));
+    for (int tick = 0; tick < TEST_TICKS; ++tick) record(&rewind, tick);
+    TEST_CHECK(rewind.entry_count == TEST_TICKS - 1);
+
+    int steps = step_back_and_compare(&rewind, TEST_TICKS - 1, 150);
+    TEST_CHECK(steps == 150);
+
+    int newest = TEST_TICKS - 1 - steps;
+    for (int tick = newest + 1; tick < TEST_TICKS; ++tick) record(&rewind, tick);
+    steps = step_back_and_compare(&rewind, TEST_TICKS - 1, TEST_TICKS);
+    TEST_CHECK(steps == TEST_TICKS - 1);
+
+    size_t image_size;
+    TEST_CHECK(rewind_step_back(&rewind, &image_size) == 0);
+    TEST_CHECK(rewind.history_bytes == 0 && rewind.history_image_bytes == 0);
+    rewind_free(&rewind);
+
+    // Small ring: old ticks are dropped and the deltas wrap around the end of the ring
+    TEST_CHECK(rewind_init(&rewind, 8192, TEST_TICKS, TEST_IMAGE_SIZE));
+    for (int tick = 0; tick < TEST_TICKS; ++tick) record(&rewind, tick);
+    int held = rewind.entry_count;
+    TEST_CHECK(held > 0 && held < TEST_TICKS - 1);
+    steps = step_back_and_compare(&rewind, TEST_TICKS - 1, TEST_TICKS);
+    TEST_CHECK(steps == held);
+    rewind_free(&rewind);
+}
+
+static void test_delta_round_trip() {
+    static uint8_t older[512], newer[512], image[512];
+    static uint8_t delta[REWIND_MAX_DELTA_SIZE(512)];
+
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        size_t size = next_random() % 512;
+        uint32_t density = next_random() % 9;       // Eighths of the bytes that differ
+        for (size_t i = 0; i < size; ++i) {
+            older[i] = (uint8_t)next_random();
+            newer[i] = (next_random() % 8 < density) ? (uint8_t)next_random() : older[i];
+        }
+
+        size_t delta_size = rewind_encode_delta(delta, newer, older, size);
+        TEST_CHECK(delta_size <= REWIND_MAX_DELTA_SIZE(size));
+        if (density == 0) TEST_CHECK(delta_size == 0);
+
+        memcpy(image, newer, size);
+        rewind_apply_delta(image, delta, delta_size);
+        TEST_CHECK_MESSAGE(memcmp(image, older, size) == 0, "delta %d (%zu bytes) does not restore the older image",
+                           iteration, size);
+    }
+}
+
+static void test_particle_state() {
+    ParticlePool pool, restored;
+    TEST_CHECK(particles_init(&pool, 4, 0xFFA040, PARTICLE_BLEND_ADDITIVE));
+    TEST_CHECK(particles_init(&restored, 4, 0xFFA040, PARTICLE_BLEND_ADDITIVE));
+    uint8_t* state = (uint8_t*)malloc(PARTICLE_STATE_MAX_SIZE);
+    TEST_CHECK(state != 0);
+
+    int counts[] = { 0, 1, PARTICLE_STATE_BLOCK - 1, PARTICLE_STATE_BLOCK, 1000, 5 * PARTICLE_STATE_BLOCK + 17 };
+    for (int c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); ++c) {
+        int count = counts[c];
+        for (int i = 0; i < count; ++i) {
+            pool.pos_x[i] = (float)i;
+            pool.pos_y[i] = (float)i * 2.0f;
+            pool.vel_x[i] = (float)i * 3.0f;
+            pool.vel_y[i] = (float)i * 4.0f;
+            pool.life[i] = (float)i * 5.0f;
+            pool.inv_lifetime[i] = (float)i * 6.0f;
+        }
+        pool.count = count;
+
+        size_t written = particles_save_state(&pool, state);
+        TEST_CHECK(written == sizeof(int) + (size_t)count * PARTICLE_STATE_RECORD_SIZE);
+        TEST_CHECK(particles_load_state(&restored, state) == written);
+        TEST_CHECK(restored.count == count);
+
+        bool same = true;
+        for (int i = 0; i < count; ++i) {
+            same = same && restored.pos_x[i] == pool.pos_x[i] && restored.pos_y[i] == pool.pos_y[i] &&
+                   restored.vel_x[i] == pool.vel_x[i] && restored.vel_y[i] == pool.vel_y[i] &&
+                   restored.life[i] == pool.life[i] && restored.inv_lifetime[i] == pool.inv_lifetime[i];
+        }
+        TEST_CHECK_MESSAGE(same, "%d particles did not survive a save/load", count);
+    }
+
+    free(state);
+    particles_free(&pool);
+    particles_free(&restored);
+}
+
+int main() {
+    test_history_round_trip();
+    test_delta_round_trip();
+    test_particle_state();
+    return test_report("rewind_test");
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdio.h>
+
+// ##################################################################
+//                          Test Checks
+// ##################################################################
+//
+// Minimal checks shared by the engine tests (one executable per module,
+// registered with CTest). A failed check prints where it failed and the
+// test keeps going; the exit code is nonzero when anything failed.
+
+static int test_failure_count;
+
+#define TEST_CHECK(condition) \
+    test_check((condition), #condition, __FILE__, __LINE__)
+
+// Same as TEST_CHECK, with a printf-style message that explains the values involved
+#define TEST_CHECK_MESSAGE(condition, ...) \
+    (test_check((condition), #condition, __FILE__, __LINE__) ? true : (printf("    "), printf(__VA_ARGS__), printf("\n"), false))
+
+static bool test_check(bool passed, const char* expression, const char* file, int line) {
+    if (!passed) {
+        test_failure_count++;
+        printf("FAILED %s:%d: %s\n", file, line, expression);
+        fflush(stdout);
+    }
+    return passed;
+}
+
+// Prints the summary line. Returns the process exit code.
+static int test_report(const char* name) {
+    if (test_failure_count == 0) {
+        printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    printf("%s: %d check(s) failed\n", name, test_failure_count);
+    return 1;
+}
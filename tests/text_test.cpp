@@ -0,0 +1,65 @@
+// Text layout limits: draw_text must draw every glyph of lines longer than one
+// layout (in chunks) and of multi-line strings (one cached layout per line),
+// and an unchanged line must hit the cache when another line changes.
+
+#include "text.h"
+#include "test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t pixels[1024 * 256];
+
+// Visible glyphs of a string (spaces and newlines emit none)
+static int count_glyphs(const char* text) {
+    int count = 0;
+    for (; *text; ++text) {
+        if (*text != ' ' && *text != '\n') count++;
+    }
+    return count;
+}
+
+int main() {
+    static TextRenderer renderer;
+    TEST_CHECK(text_init(&renderer, 1, 0xFFFFFF));
+
+    GameBuffer buffer;
+    buffer.memory = pixels;
+    buffer.width = 1024;
+    buffer.height = 256;
+    buffer.pitch = 1024 * 4;
+
+    // Long line: 700 characters, several layouts wide. The end goes off screen,
+    // so compare against a buffer wide enough for the whole line.
+    static char long_line[701];
+    for (int i = 0; i < 700; ++i) long_line[i] = (char)('A' + i % 26);
+    long_line[700] = 0;
+
+    static uint32_t wide_pixels[8192 * 16];
+    GameBuffer wide = { wide_pixels, 8192, 16, 8192 * 4 };
+    int drawn = draw_text(&wide, &renderer, long_line, 0, 0);
+    TEST_CHECK_MESSAGE(drawn == 700, "long line: %d of 700 glyphs drawn", drawn);
+    TEST_CHECK(renderer.truncated_layouts == 0);
+
+    // Multi-line string longer than one layout in total (each line fits)
+    static char block[1024];
+    block[0] = 0;
+    for (int line = 0; line < 12; ++line) {
+        strcat(block, "LINE OF THE STATS OVERLAY 0123456789 ABCDEF");
+        if (line < 11) strcat(block, "\n");
+    }
+    TEST_CHECK(strlen(block) > TEXT_MAX_LAYOUT_CHARS);
+    drawn = draw_text(&buffer, &renderer, block, 8, 8);
+    TEST_CHECK_MESSAGE(drawn == count_glyphs(block), "multi-line: %d of %d glyphs drawn", drawn, count_glyphs(block));
+
+    // Changing one line: the other line is still a cache hit
+    draw_text(&buffer, &renderer, "KERNELS AVX2\nFRAME 16.67 MS", 8, 8);
+    uint32_t hits = renderer.cache_hits;
+    uint32_t misses = renderer.cache_misses;
+    draw_text(&buffer, &renderer, "KERNELS AVX2\nFRAME 16.71 MS", 8, 8);
+    TEST_CHECK(renderer.cache_hits - hits == 1);
+    TEST_CHECK(renderer.cache_misses - misses == 1);
+
+    free(renderer.font.atlas.pixels);
+    return test_report("text_test");
+}
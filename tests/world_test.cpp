@@ -0,0 +1,92 @@
+// World grid queries:
+//   - Overlap is strict: boxes sharing only an edge (including a cell boundary) are not reported.
+//   - Objects partly or fully outside the level bounds are still found by queries that reach them.
+//   - Objects spanning several cells are reported once.
+
+#include "world.h"
+#include "test.h"
+
+static bool query_finds(World* world, AABB area, int object) {
+    int found[16];
+    int count = world_query(world, area, found, 16);
+    for (int i = 0; i < count; ++i) {
+        if (found[i] == object) return true;
+    }
+    return false;
+}
+
+static void test_touching() {
+    World world;
+    TEST_CHECK(world_init(&world, 1024.0f, 0.0f, 1024.0f, 4));
+
+    // Ends exactly on the boundary between cells 0 and 1
+    AABB box = { 156.0f, 100.0f, 100.0f, 50.0f };
+    int object = world_add_object(&world, box, 0xFFFFFFFF);
+    TEST_CHECK(world_build_grid(&world));
+
+    AABB right = { 256.0f, 100.0f, 32.0f, 32.0f };
+    AABB above = { 160.0f, 68.0f, 32.0f, 32.0f };
+    AABB inside_right = { 255.5f, 100.0f, 32.0f, 32.0f };
+    AABB inside_above = { 160.0f, 68.5f, 32.0f, 32.0f };
+
+    TEST_CHECK(!query_finds(&world, right, object));
+    TEST_CHECK(!query_finds(&world, above, object));
+    TEST_CHECK(query_finds(&world, inside_right, object));
+    TEST_CHECK(query_finds(&world, inside_above, object));
+
+    world_free(&world);
+}
+
+static void test_outside_bounds() {
+    World world;
+    TEST_CHECK(world_init(&world, 1024.0f, -512.0f, 1024.0f, 8));
+
+    AABB left = { -300.0f, 0.0f, 100.0f, 20.0f };           // Entirely left of the level
+    AABB right = { 1000.0f, 0.0f, 400.0f, 20.0f };          // Sticks out on the right
+    AABB below = { 500.0f, 700.0f, 100.0f, 20.0f };         // Entirely below the level
+    AABB far_away = { -1.0e12f, -1.0e12f, 1.0e7f, 1.0e7f };     // Would overflow an int cell index
+    int left_object = world_add_object(&world, left, 0xFFFFFFFF);
+    int right_object = world_add_object(&world, right, 0xFFFFFFFF);
+    int below_object = world_add_object(&world, below, 0xFFFFFFFF);
+    int far_object = world_add_object(&world, far_away, 0xFFFFFFFF);
+    TEST_CHECK(world_build_grid(&world));
+
+    AABB probe_left = { -260.0f, 5.0f, 10.0f, 10.0f };
+    AABB probe_right = { 1300.0f, 5.0f, 10.0f, 10.0f };
+    AABB probe_below = { 550.0f, 705.0f, 10.0f, 10.0f };
+    AABB probe_far = { -1.0e12f, -1.0e12f, 1.0e6f, 1.0e6f };
+    AABB probe_inside = { 100.0f, 100.0f, 10.0f, 10.0f };
+
+    TEST_CHECK(query_finds(&world, probe_left, left_object));
+    TEST_CHECK(query_finds(&world, probe_right, right_object));
+    TEST_CHECK(query_finds(&world, probe_below, below_object));
+    TEST_CHECK(query_finds(&world, probe_far, far_object));
+
+    int found[16];
+    TEST_CHECK(world_query(&world, probe_inside, found, 16) == 0);
+
+    world_free(&world);
+}
+
+static void test_spanning_objects() {
+    World world;
+    TEST_CHECK(world_init(&world, 2048.0f, 0.0f, 2048.0f, 2));
+
+    // Covers 4 x 4 cells
+    AABB big = { 100.0f, 100.0f, 900.0f, 900.0f };
+    world_add_object(&world, big, 0xFFFFFFFF);
+    TEST_CHECK(world_build_grid(&world));
+
+    AABB everything = { 0.0f, 0.0f, 2048.0f, 2048.0f };
+    int found[16];
+    TEST_CHECK(world_query(&world, everything, found, 16) == 1);
+
+    world_free(&world);
+}
+
+int main() {
+    test_touching();
+    test_outside_bounds();
+    test_spanning_objects();
+    return test_report("world_test");
+}